@@ -0,0 +1,230 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "PageAllocator.hpp"
+
+namespace md {
+
+/// @brief Alignment (in bytes) of all heap buffers used by processing kernels
+constexpr size_t kBufferAlignment = 64;
+
+/**
+ * \brief Number of samples of type T that fit in one aligned SIMD register block.
+ *
+ * \tparam T Sample type.
+ *
+ * \return Number of lanes (always at least 1).
+ */
+template <typename T>
+constexpr size_t simdLanes() {
+    return kBufferAlignment / sizeof(T) > 0 ? kBufferAlignment / sizeof(T) : 1;
+}
+
+/**
+ * \brief Rounds a length up to a whole number of SIMD lanes.
+ *
+ * \tparam T Sample type.
+ * \param length Requested number of samples.
+ *
+ * \return Smallest multiple of simdLanes<T>() that is >= length.
+ */
+template <typename T>
+constexpr size_t paddedLength(size_t length) {
+    return (length + simdLanes<T>() - 1) / simdLanes<T>() * simdLanes<T>();
+}
+
+/**
+ * \brief Aligned, zero-padded heap storage for coefficients and delay lines.
+ *
+ * Allocates a contiguous block aligned to kBufferAlignment whose capacity is
+ * rounded up to a whole number of SIMD lanes. The padding is zero-filled so
+ * kernels may safely read full lanes past the logical end. Memory is only
+ * allocated by the constructor and resize(), never by element access, which
+ * makes the buffer suitable for state that is set up once at configuration
+ * time and then used on the processing path.
+ *
+ * Large signal and state buffers can be given a MemoryPolicy to back them
+ * with huge pages and fault them in when they are allocated.
+ *
+ * \tparam T Element type (must be trivially copyable).
+ */
+template <typename T>
+class AlignedBuffer {
+   private:
+    /// @brief Aligned storage
+    T* m_data = nullptr;
+    /// @brief Logical number of elements
+    size_t m_size = 0;
+    /// @brief Allocated number of elements (multiple of simdLanes<T>())
+    size_t m_capacity = 0;
+    /// @brief How the storage is allocated
+    MemoryPolicy m_policy;
+
+    /// @brief Releases the storage
+    void release() {
+        deallocatePages(m_data, m_capacity * sizeof(T), kBufferAlignment, m_policy);
+        m_data = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+   public:
+    /**
+     * \brief Creates an empty buffer.
+     */
+    AlignedBuffer() { static_assert(std::is_trivially_copyable<T>::value, "Element type must be trivially copyable!"); }
+
+    /**
+     * \brief Creates a zero-filled buffer of the given size.
+     *
+     * \param size Number of elements.
+     */
+    explicit AlignedBuffer(size_t size) : AlignedBuffer() { resize(size); }
+
+    /**
+     * \brief Creates a zero-filled buffer with an allocation policy.
+     *
+     * \param size Number of elements.
+     * \param policy How the storage (and any later, larger storage) is allocated.
+     */
+    AlignedBuffer(size_t size, const MemoryPolicy& policy) : AlignedBuffer() {
+        m_policy = policy;
+        resize(size);
+    }
+
+    /**
+     * \brief Creates a copy of an existing buffer.
+     *
+     * \param other The source buffer to copy from.
+     */
+    AlignedBuffer(const AlignedBuffer<T>& other) : AlignedBuffer() {
+        m_policy = other.m_policy;
+        resize(other.m_size);
+        std::copy(other.m_data, other.m_data + paddedLength<T>(other.m_size), m_data);
+    }
+
+    /**
+     * \brief Takes ownership of another buffer's storage.
+     *
+     * \param other The source buffer (left empty).
+     */
+    AlignedBuffer(AlignedBuffer<T>&& other) noexcept
+        : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity), m_policy(other.m_policy) {
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+
+    /// @brief Releases the storage
+    ~AlignedBuffer() { release(); }
+
+    /// @brief Copy assignment operator (takes over the policy of the source, like the copy constructor)
+    /// @param other Buffer to copy from
+    /// @return Reference to this buffer
+    AlignedBuffer& operator=(const AlignedBuffer<T>& other) {
+        if (this != &other) {
+            if (m_policy != other.m_policy) {
+                // Storage must be released with the policy it was allocated with
+                release();
+                m_policy = other.m_policy;
+            }
+            resize(other.m_size);
+            std::copy(other.m_data, other.m_data + paddedLength<T>(other.m_size), m_data);
+        }
+        return *this;
+    }
+
+    /// @brief Move assignment operator
+    /// @param other Buffer to take storage from
+    /// @return Reference to this buffer
+    AlignedBuffer& operator=(AlignedBuffer<T>&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            m_policy = other.m_policy;
+            other.m_data = nullptr;
+            other.m_size = 0;
+            other.m_capacity = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * \brief Changes the logical size of the buffer.
+     *
+     * Reallocates only if the padded capacity grows. All elements, including
+     * the padding, are zeroed. Intended to be called at configuration time.
+     *
+     * \param size New number of elements.
+     */
+    void resize(size_t size) {
+        size_t capacity = paddedLength<T>(size);
+        if (capacity > m_capacity) {
+            release();
+            m_data = static_cast<T*>(allocatePages(capacity * sizeof(T), kBufferAlignment, m_policy));
+            m_capacity = capacity;
+            m_size = size;
+            // Fresh mappings are already zero, clearing them again would only touch every page twice
+            if (!detail::isMapped(capacity * sizeof(T), m_policy)) {
+                fill(static_cast<T>(0));
+            }
+            return;
+        }
+        m_size = size;
+        fill(static_cast<T>(0));
+    }
+
+    /// @brief Gets allocation policy
+    /// @return Policy of the storage
+    const MemoryPolicy& policy() const { return m_policy; }
+
+    /**
+     * \brief Sets every element, including the padding, to a value.
+     *
+     * \param value Value to assign.
+     */
+    void fill(T value) { std::fill(m_data, m_data + m_capacity, value); }
+
+    /// @brief Gets logical number of elements
+    /// @return Number of elements
+    size_t size() const { return m_size; }
+
+    /// @brief Gets allocated number of elements
+    /// @return Padded capacity
+    size_t capacity() const { return m_capacity; }
+
+    /// @brief Gets pointer to aligned data
+    /// @return Pointer to first element
+    T* data() { return m_data; }
+    /// @brief Gets const pointer to aligned data
+    /// @return Const pointer to first element
+    const T* data() const { return m_data; }
+
+    /// @brief Unchecked element access
+    /// @param index Element index
+    /// @return Reference to the element
+    T& operator[](size_t index) { return m_data[index]; }
+    /// @brief Unchecked const element access
+    /// @param index Element index
+    /// @return Const reference to the element
+    const T& operator[](size_t index) const { return m_data[index]; }
+
+    /// @brief Equality comparison operator (compares logical elements)
+    /// @param other Buffer to compare with
+    /// @return true if buffers are equal
+    bool operator==(const AlignedBuffer<T>& other) const {
+        return m_size == other.m_size && std::equal(m_data, m_data + m_size, other.m_data);
+    }
+
+    /// @brief Inequality comparison operator
+    /// @param other Buffer to compare with
+    /// @return true if buffers are not equal
+    bool operator!=(const AlignedBuffer<T>& other) const { return !(*this == other); }
+};
+}  // namespace md
@@ -0,0 +1,219 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+
+namespace md {
+/**
+ * \brief One FIR design applied to a batch of independent signals.
+ *
+ * Filters many short signals with the same coefficients, each one starting
+ * from a cleared delay line, i.e. the result equals calling reset() and
+ * process() of a FIR filter for every signal. The batch is treated as a
+ * matrix with one signal per row and the convolution as a blocked matrix
+ * product with the Toeplitz matrix of the coefficients, without ever
+ * materializing it: rows are taken kSignalTile at a time, each row is staged
+ * with Size-1 zeros of history in a scratch tile sized for the L2 cache, and
+ * the kernel accumulates kSignalTile x kTimeTile outputs in registers. Every
+ * coefficient load is then shared by kSignalTile rows.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class BatchFirFilter {
+   private:
+    /// @brief Number of signals evaluated together
+    static constexpr size_t kSignalTile = 4;
+    /// @brief Number of output samples evaluated together
+    static constexpr size_t kTimeTile = 8;
+    /// @brief Target size of the staged tile in bytes (fits in L2)
+    static constexpr size_t kTileBytes = 128 * 1024;
+
+    /// \brief Number of coefficients
+    size_t m_size = 0;
+    /// \brief Number of coefficients rounded up to SIMD lanes
+    size_t m_padded = 0;
+    /// \brief Number of samples of a row staged per tile
+    size_t m_chunk = 0;
+    /// \brief Length of one staged row: m_padded-1 history samples plus m_chunk
+    size_t m_rowLength = 0;
+    /// \brief Time-reversed coefficients, leading padding is zero
+    AlignedBuffer<T> m_coeffs;
+    /// \brief kSignalTile staged rows
+    AlignedBuffer<T> m_tile;
+
+    /**
+     * \brief Filters a group of Signals rows.
+     *
+     * \tparam Signals Number of rows in the group (1..kSignalTile).
+     * \param input First input row of the group.
+     * \param inStride Distance between input rows.
+     * \param output First output row of the group (may equal input).
+     * \param outStride Distance between output rows.
+     * \param length Number of samples per row.
+     */
+    template <size_t Signals>
+    void kernel(const T* input, size_t inStride, T* output, size_t outStride, size_t length) {
+        const size_t history = m_padded - 1;
+        const size_t first = m_padded - m_size;
+        const T* coeffs = m_coeffs.data();
+        T* rows[Signals];
+        for (size_t s = 0; s < Signals; s++) {
+            rows[s] = m_tile.data() + s * m_rowLength;
+            std::fill(rows[s], rows[s] + history, static_cast<T>(0.0));
+        }
+        for (size_t pos = 0; pos < length; pos += m_chunk) {
+            size_t count = std::min(m_chunk, length - pos);
+            for (size_t s = 0; s < Signals; s++) {
+                const T* src = input + s * inStride + pos;
+                std::copy(src, src + count, rows[s] + history);
+            }
+            size_t j = 0;
+            for (; j + kTimeTile <= count; j += kTimeTile) {
+                T acc[Signals][kTimeTile] = {};
+                for (size_t k = first; k < m_padded; k++) {
+                    const T c = coeffs[k];
+                    for (size_t s = 0; s < Signals; s++) {
+                        const T* x = rows[s] + j + k;
+                        for (size_t t = 0; t < kTimeTile; t++) {
+                            acc[s][t] += c * x[t];
+                        }
+                    }
+                }
+                for (size_t s = 0; s < Signals; s++) {
+                    std::copy(acc[s], acc[s] + kTimeTile, output + s * outStride + pos + j);
+                }
+            }
+            for (; j < count; j++) {
+                for (size_t s = 0; s < Signals; s++) {
+                    T acc = static_cast<T>(0.0);
+                    for (size_t k = first; k < m_padded; k++) {
+                        acc += coeffs[k] * rows[s][j + k];
+                    }
+                    output[s * outStride + pos + j] = acc;
+                }
+            }
+            for (size_t s = 0; s < Signals; s++) {
+                std::copy(rows[s] + count, rows[s] + count + history, rows[s]);
+            }
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a batch filter from coefficients.
+     *
+     * \param factors Filter coefficients [h0, h1, ..., h(Size-1)].
+     *
+     * \throws std::invalid_argument if factors is empty.
+     */
+    explicit BatchFirFilter(const std::vector<T>& factors) : m_size(factors.size()) {
+        if (factors.empty()) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        m_padded = paddedLength<T>(m_size);
+        size_t budget = kTileBytes / (kSignalTile * sizeof(T));
+        m_chunk = budget > m_padded + 8 * kTimeTile ? budget - m_padded : 8 * kTimeTile;
+        m_chunk = m_chunk / kTimeTile * kTimeTile;
+        m_rowLength = m_padded - 1 + m_chunk;
+        m_coeffs.resize(m_padded);
+        for (size_t i = 0; i < m_size; i++) {
+            m_coeffs[m_padded - 1 - i] = factors[i];
+        }
+        m_tile.resize(kSignalTile * m_rowLength);
+    }
+
+    /**
+     * \brief Creates a batch filter from a fixed-size design.
+     *
+     * \tparam Size Number of coefficients of the design.
+     * \param factors Coefficients, e.g. FirFilter::getFactors().
+     */
+    template <size_t Size>
+    explicit BatchFirFilter(const std::array<T, Size>& factors)
+        : BatchFirFilter(std::vector<T>(factors.begin(), factors.end())) {}
+
+    /**
+     * \brief Filters a batch of signals out-of-place.
+     *
+     * \param input First input signal; signal s starts at input + s * inStride.
+     * \param inStride Distance between consecutive input signals (>= length).
+     * \param output First output signal; signal s starts at output + s * outStride.
+     * \param outStride Distance between consecutive output signals (>= length).
+     * \param numSignals Number of signals.
+     * \param length Number of samples per signal.
+     *
+     * \throws std::invalid_argument if a pointer is nullptr, a size is 0 or a stride is too small.
+     */
+    void process(const T* input, size_t inStride, T* output, size_t outStride, size_t numSignals, size_t length) {
+        if (input == nullptr || output == nullptr || numSignals == 0 || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        if (inStride < length || outStride < length) {
+            throw std::invalid_argument("Stride must not be smaller than signal length!");
+        }
+        size_t s = 0;
+        for (; s + kSignalTile <= numSignals; s += kSignalTile) {
+            kernel<kSignalTile>(input + s * inStride, inStride, output + s * outStride, outStride, length);
+        }
+        switch (numSignals - s) {
+            case 3:
+                kernel<3>(input + s * inStride, inStride, output + s * outStride, outStride, length);
+                break;
+            case 2:
+                kernel<2>(input + s * inStride, inStride, output + s * outStride, outStride, length);
+                break;
+            case 1:
+                kernel<1>(input + s * inStride, inStride, output + s * outStride, outStride, length);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * \brief Filters a batch of signals in-place.
+     *
+     * \param signals First signal; signal s starts at signals + s * stride.
+     * \param numSignals Number of signals.
+     * \param length Number of samples per signal.
+     * \param stride Distance between consecutive signals (>= length).
+     *
+     * \throws std::invalid_argument if signals is nullptr, a size is 0 or stride is too small.
+     */
+    void process(T* signals, size_t numSignals, size_t length, size_t stride) {
+        process(signals, stride, signals, stride, numSignals, length);
+    }
+
+    /**
+     * \brief Filters a batch of contiguous signals in-place.
+     *
+     * \param signals numSignals x length matrix (row per signal).
+     * \param numSignals Number of signals.
+     * \param length Number of samples per signal.
+     *
+     * \throws std::invalid_argument if signals is nullptr or a size is 0.
+     */
+    void process(T* signals, size_t numSignals, size_t length) { process(signals, numSignals, length, length); }
+
+    /**
+     * \brief Gets a copy of the coefficients.
+     *
+     * \return Coefficients in natural order [h0, h1, ..., h(Size-1)].
+     */
+    std::vector<T> getFactors() const {
+        std::vector<T> factors(m_size);
+        for (size_t i = 0; i < m_size; i++) {
+            factors[i] = m_coeffs[m_padded - 1 - i];
+        }
+        return factors;
+    }
+
+    /// @brief Gets filter length
+    /// @return Number of coefficients
+    size_t size() const { return m_size; }
+};
+}  // namespace md
@@ -0,0 +1,391 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "DynamicFirFilter.hpp"
+
+namespace md {
+/**
+ * \brief Position of one array sensor in meters.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+struct SensorPosition {
+    /// @brief x coordinate
+    T x;
+    /// @brief y coordinate
+    T y;
+    /// @brief z coordinate
+    T z;
+};
+
+/**
+ * \brief Look direction of a beam.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+struct LookDirection {
+    /// @brief Azimuth in radians, measured in the x-y plane from the x axis
+    T azimuth;
+    /// @brief Elevation in radians above the x-y plane
+    T elevation;
+};
+
+namespace detail {
+/**
+ * \brief Computes plane-wave arrival times of a direction at every sensor.
+ *
+ * A wave coming from the look direction reaches sensor s at
+ * t_s = -(p_s . u) / c relative to the array origin, where u is the unit
+ * vector pointing towards the source.
+ *
+ * \param sensors Sensor positions.
+ * \param direction Look direction.
+ * \param speedOfSound Propagation speed in m/s.
+ *
+ * \return Arrival time of every sensor in seconds.
+ */
+template <typename T>
+std::vector<T> arrivalTimes(const std::vector<SensorPosition<T>>& sensors, const LookDirection<T>& direction,
+                            T speedOfSound) {
+    T ux = std::cos(direction.elevation) * std::cos(direction.azimuth);
+    T uy = std::cos(direction.elevation) * std::sin(direction.azimuth);
+    T uz = std::sin(direction.elevation);
+    std::vector<T> times(sensors.size());
+    for (size_t s = 0; s < sensors.size(); s++) {
+        times[s] = -(sensors[s].x * ux + sensors[s].y * uy + sensors[s].z * uz) / speedOfSound;
+    }
+    return times;
+}
+}  // namespace detail
+
+/**
+ * \brief Time-domain delay-and-sum beamformer.
+ *
+ * Aligns the sensor signals for one look direction and averages them. Each
+ * channel is delayed by an integer number of samples, realized by reading
+ * its linear delay line at an offset, plus a fractional part realized by a
+ * Blackman-windowed sinc FIR evaluated with the block FIR kernel of
+ * DynamicFirFilter. All delay lines and coefficient buffers are allocated at
+ * construction and resized only by steer() when the largest delay grows.
+ *
+ * The output lags the array origin by a constant latency() samples.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class DelayAndSumBeamformer {
+   private:
+    /// @brief Number of samples processed per kernel call
+    static constexpr size_t kBlock = 256;
+
+    /// \brief Sensor positions
+    std::vector<SensorPosition<T>> m_sensors;
+    /// \brief Sampling frequency in Hz
+    T m_sampleRate;
+    /// \brief Propagation speed in m/s
+    T m_speedOfSound;
+    /// \brief Number of fractional delay taps
+    size_t m_taps;
+    /// \brief Number of taps rounded up to SIMD lanes
+    size_t m_padded;
+    /// \brief Largest integer delay of the current steering
+    size_t m_maxDelay = 0;
+    /// \brief Integer delay of each channel
+    std::vector<size_t> m_delays;
+    /// \brief Time-reversed fractional delay taps, one padded row per channel
+    AlignedBuffer<T> m_coeffs;
+    /// \brief Linear delay lines, one row of m_rowLength per channel
+    AlignedBuffer<T> m_work;
+    /// \brief Length of one delay line row
+    size_t m_rowLength = 0;
+    /// \brief Output of one channel for the current block
+    AlignedBuffer<T> m_channelOut;
+
+   public:
+    /**
+     * \brief Creates a beamformer for a sensor array.
+     *
+     * \param sensors Sensor positions in meters.
+     * \param sampleRate Sampling frequency in Hz.
+     * \param speedOfSound Propagation speed in m/s (343 for air).
+     * \param taps Number of taps of the fractional delay filters (>= 2).
+     *
+     * \throws std::invalid_argument if the array is empty or a parameter is out of range.
+     */
+    DelayAndSumBeamformer(const std::vector<SensorPosition<T>>& sensors, T sampleRate, T speedOfSound, size_t taps = 16)
+        : m_sensors(sensors), m_sampleRate(sampleRate), m_speedOfSound(speedOfSound), m_taps(taps) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+        if (sensors.empty() || sampleRate <= 0 || speedOfSound <= 0 || taps < 2) {
+            throw std::invalid_argument("Invalid beamformer parameters!");
+        }
+        m_padded = paddedLength<T>(taps);
+        m_delays.assign(sensors.size(), 0);
+        m_coeffs.resize(sensors.size() * m_padded);
+        m_channelOut.resize(kBlock);
+        steer(LookDirection<T>{0, 0});
+    }
+
+    /**
+     * \brief Steers the beam to a look direction.
+     *
+     * Computes the integer and fractional delay of every channel and designs
+     * the fractional delay filters. Clears the delay lines if the largest
+     * integer delay changes.
+     *
+     * \param direction Look direction.
+     */
+    void steer(const LookDirection<T>& direction) {
+        std::vector<T> times = detail::arrivalTimes(m_sensors, direction, m_speedOfSound);
+        T latest = *std::max_element(times.begin(), times.end());
+        std::vector<T> delays(m_sensors.size());
+        size_t maxDelay = 0;
+        for (size_t s = 0; s < m_sensors.size(); s++) {
+            delays[s] = (latest - times[s]) * m_sampleRate;
+            maxDelay = std::max(maxDelay, static_cast<size_t>(std::floor(delays[s])));
+        }
+        const T center = static_cast<T>(m_taps / 2 - 1);
+        const T width = static_cast<T>(m_taps);
+        for (size_t s = 0; s < m_sensors.size(); s++) {
+            T whole = std::floor(delays[s]);
+            T frac = delays[s] - whole;
+            m_delays[s] = static_cast<size_t>(whole);
+            T* row = m_coeffs.data() + s * m_padded;
+            std::fill(row, row + m_padded, static_cast<T>(0.0));
+            T sum = 0;
+            for (size_t n = 0; n < m_taps; n++) {
+                T x = static_cast<T>(n) - center - frac;
+                T sinc = x == 0 ? static_cast<T>(1.0) : std::sin(static_cast<T>(M_PI) * x) / (static_cast<T>(M_PI) * x);
+                T window = static_cast<T>(0.42) + static_cast<T>(0.5) * std::cos(2 * static_cast<T>(M_PI) * x / width) +
+                           static_cast<T>(0.08) * std::cos(4 * static_cast<T>(M_PI) * x / width);
+                row[m_padded - 1 - n] = sinc * window;
+                sum += sinc * window;
+            }
+            for (size_t n = 0; n < m_taps; n++) {
+                row[m_padded - 1 - n] /= sum;
+            }
+        }
+        if (maxDelay != m_maxDelay || m_work.size() == 0) {
+            m_maxDelay = maxDelay;
+            m_rowLength = m_maxDelay + m_padded - 1 + kBlock;
+            m_work.resize(m_sensors.size() * m_rowLength);
+        }
+    }
+
+    /**
+     * \brief Forms the beam from a block of planar sensor signals.
+     *
+     * \param inputs numSensors() pointers to sensor signals.
+     * \param length Number of samples per sensor.
+     * \param output Beam output of length samples (average of aligned sensors).
+     *
+     * \throws std::invalid_argument if a pointer is nullptr or length is 0.
+     */
+    void process(const T* const* inputs, size_t length, T* output) {
+        if (inputs == nullptr || output == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const size_t history = m_maxDelay + m_padded - 1;
+        const T scale = static_cast<T>(1.0) / static_cast<T>(m_sensors.size());
+        for (size_t pos = 0; pos < length; pos += kBlock) {
+            size_t count = std::min(kBlock, length - pos);
+            std::fill(output + pos, output + pos + count, static_cast<T>(0.0));
+            for (size_t s = 0; s < m_sensors.size(); s++) {
+                T* work = m_work.data() + s * m_rowLength;
+                std::copy(inputs[s] + pos, inputs[s] + pos + count, work + history);
+                const T* window = work + m_maxDelay - m_delays[s];
+                detail::firBlockKernel(m_coeffs.data() + s * m_padded, m_padded - m_taps, m_padded, window,
+                                       m_channelOut.data(), count);
+                for (size_t j = 0; j < count; j++) {
+                    output[pos + j] += scale * m_channelOut[j];
+                }
+                std::copy(work + count, work + count + history, work);
+            }
+        }
+    }
+
+    /**
+     * \brief Resets the beamformer to its initial state.
+     *
+     * Clears all delay lines. Steering is not affected.
+     */
+    void reset() { m_work.fill(static_cast<T>(0.0)); }
+
+    /// @brief Gets number of sensors
+    /// @return Number of input channels
+    size_t numSensors() const { return m_sensors.size(); }
+
+    /// @brief Gets constant processing latency added by the fractional delay filters
+    /// @return Latency in samples, on top of the alignment delays
+    size_t latency() const { return m_taps / 2 - 1; }
+};
+
+/**
+ * \brief Frequency-domain beamformer for many look directions at once.
+ *
+ * Applies delay-and-sum steering weights to STFT frames of all sensors
+ * (e.g. one Stft per channel) and produces the spectrum of every beam. For
+ * each bin the beams are a complex matrix-vector product Y = G * X of the
+ * beams x sensors weight matrix with the sensor spectra. Weights are stored
+ * as separate real and imaginary planes in [bin][sensor][beam] order, so the
+ * kernel sweeps all beams of a bin with contiguous, vectorized multiply-adds
+ * and every sensor value is loaded once per bin.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class FrequencyDomainBeamformer {
+   private:
+    /// \brief Number of sensors
+    size_t m_numSensors;
+    /// \brief Number of beams
+    size_t m_numBeams;
+    /// \brief Number of spectrum bins per frame
+    size_t m_numBins;
+    /// \brief Real part of the weights, [bin][sensor][beam]
+    AlignedBuffer<T> m_weightsRe;
+    /// \brief Imaginary part of the weights, [bin][sensor][beam]
+    AlignedBuffer<T> m_weightsIm;
+    /// \brief Real part of beam accumulators for one bin
+    AlignedBuffer<T> m_accRe;
+    /// \brief Imaginary part of beam accumulators for one bin
+    AlignedBuffer<T> m_accIm;
+
+    /**
+     * \brief Accumulates all beams of one bin.
+     *
+     * \param frame Sensor spectra of one frame, [sensor][bin].
+     * \param bin Bin index.
+     */
+    void beamBin(const std::complex<T>* frame, size_t bin) {
+        T* accRe = m_accRe.data();
+        T* accIm = m_accIm.data();
+        std::fill(accRe, accRe + m_numBeams, static_cast<T>(0.0));
+        std::fill(accIm, accIm + m_numBeams, static_cast<T>(0.0));
+        const size_t plane = bin * m_numSensors * m_numBeams;
+        for (size_t s = 0; s < m_numSensors; s++) {
+            const T xr = frame[s * m_numBins + bin].real();
+            const T xi = frame[s * m_numBins + bin].imag();
+            const T* gr = m_weightsRe.data() + plane + s * m_numBeams;
+            const T* gi = m_weightsIm.data() + plane + s * m_numBeams;
+            for (size_t b = 0; b < m_numBeams; b++) {
+                accRe[b] += gr[b] * xr - gi[b] * xi;
+                accIm[b] += gr[b] * xi + gi[b] * xr;
+            }
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a beamformer for a set of look directions.
+     *
+     * \param sensors Sensor positions in meters.
+     * \param directions Look directions, one beam each.
+     * \param fftSize FFT length of the STFT frames.
+     * \param sampleRate Sampling frequency in Hz.
+     * \param speedOfSound Propagation speed in m/s (343 for air).
+     *
+     * \throws std::invalid_argument if the array or direction list is empty or a parameter is out of range.
+     */
+    FrequencyDomainBeamformer(const std::vector<SensorPosition<T>>& sensors,
+                              const std::vector<LookDirection<T>>& directions, size_t fftSize, T sampleRate,
+                              T speedOfSound)
+        : m_numSensors(sensors.size()), m_numBeams(directions.size()), m_numBins(fftSize / 2 + 1) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+        if (sensors.empty() || directions.empty() || fftSize < 2 || sampleRate <= 0 || speedOfSound <= 0) {
+            throw std::invalid_argument("Invalid beamformer parameters!");
+        }
+        m_weightsRe.resize(m_numBins * m_numSensors * m_numBeams);
+        m_weightsIm.resize(m_numBins * m_numSensors * m_numBeams);
+        m_accRe.resize(m_numBeams);
+        m_accIm.resize(m_numBeams);
+        const T scale = static_cast<T>(1.0) / static_cast<T>(m_numSensors);
+        for (size_t b = 0; b < m_numBeams; b++) {
+            std::vector<T> times = detail::arrivalTimes(sensors, directions[b], speedOfSound);
+            for (size_t k = 0; k < m_numBins; k++) {
+                T omega = 2 * static_cast<T>(M_PI) * static_cast<T>(k) * sampleRate / static_cast<T>(fftSize);
+                for (size_t s = 0; s < m_numSensors; s++) {
+                    size_t index = (k * m_numSensors + s) * m_numBeams + b;
+                    m_weightsRe[index] = scale * std::cos(omega * times[s]);
+                    m_weightsIm[index] = scale * std::sin(omega * times[s]);
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Computes beam spectra for a batch of frames.
+     *
+     * \param spectra Sensor spectra, numFrames x numSensors() x bins() values
+     *                ([frame][sensor][bin]).
+     * \param numFrames Number of frames.
+     * \param beams Beam spectra, numFrames x numBeams() x bins() values
+     *              ([frame][beam][bin]).
+     *
+     * \throws std::invalid_argument if a pointer is nullptr.
+     */
+    void process(const std::complex<T>* spectra, size_t numFrames, std::complex<T>* beams) {
+        if (spectra == nullptr || beams == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t f = 0; f < numFrames; f++) {
+            const std::complex<T>* frame = spectra + f * m_numSensors * m_numBins;
+            std::complex<T>* out = beams + f * m_numBeams * m_numBins;
+            for (size_t k = 0; k < m_numBins; k++) {
+                beamBin(frame, k);
+                for (size_t b = 0; b < m_numBeams; b++) {
+                    out[b * m_numBins + k] = std::complex<T>(m_accRe[b], m_accIm[b]);
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Computes the output power of every beam for a batch of frames.
+     *
+     * Sums |Y_b(k)|^2 over all bins, which gives a steered response power
+     * map for direction finding without storing beam spectra.
+     *
+     * \param spectra Sensor spectra, [frame][sensor][bin].
+     * \param numFrames Number of frames.
+     * \param power Output, numFrames x numBeams() values.
+     *
+     * \throws std::invalid_argument if a pointer is nullptr.
+     */
+    void power(const std::complex<T>* spectra, size_t numFrames, T* power) {
+        if (spectra == nullptr || power == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t f = 0; f < numFrames; f++) {
+            const std::complex<T>* frame = spectra + f * m_numSensors * m_numBins;
+            T* out = power + f * m_numBeams;
+            std::fill(out, out + m_numBeams, static_cast<T>(0.0));
+            for (size_t k = 0; k < m_numBins; k++) {
+                beamBin(frame, k);
+                for (size_t b = 0; b < m_numBeams; b++) {
+                    out[b] += m_accRe[b] * m_accRe[b] + m_accIm[b] * m_accIm[b];
+                }
+            }
+        }
+    }
+
+    /// @brief Gets number of sensors
+    /// @return Number of input channels
+    size_t numSensors() const { return m_numSensors; }
+
+    /// @brief Gets number of beams
+    /// @return Number of look directions
+    size_t numBeams() const { return m_numBeams; }
+
+    /// @brief Gets number of bins per frame
+    /// @return fftSize/2+1
+    size_t bins() const { return m_numBins; }
+};
+}  // namespace md
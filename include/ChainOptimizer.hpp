@@ -0,0 +1,565 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "DynamicFirFilter.hpp"
+#include "DynamicGain.hpp"
+#include "DynamicIirFilter.hpp"
+#include "DynamicSosFilter.hpp"
+#include "FilterChain.hpp"
+
+namespace md {
+/**
+ * \brief Summary of a ChainOptimizer run.
+ */
+struct ChainReport {
+    /// @brief Number of top-level stages before optimization
+    size_t stagesBefore = 0;
+    /// @brief Number of top-level stages after optimization
+    size_t stagesAfter = 0;
+    /// @brief Multiply-accumulates per sample before optimization
+    size_t costBefore = 0;
+    /// @brief Multiply-accumulates per sample after optimization
+    size_t costAfter = 0;
+};
+
+namespace detail {
+/**
+ * \brief Real root or complex-conjugate root pair of a polynomial.
+ *
+ * \tparam T Data type.
+ */
+template <typename T>
+struct RootGroup {
+    /// @brief Root (upper half-plane member for a pair)
+    std::complex<T> value;
+    /// @brief true if conj(value) is a root too
+    bool pair;
+};
+
+/**
+ * \brief Appends the roots of z^2 + p z + q.
+ *
+ * \param p Linear coefficient.
+ * \param q Constant coefficient.
+ * \param roots Output list.
+ */
+template <typename T>
+void quadraticRoots(T p, T q, std::vector<RootGroup<T>>& roots) {
+    T half = p / 2;
+    T disc = half * half - q;
+    if (disc < 0) {
+        roots.push_back({std::complex<T>(-half, std::sqrt(-disc)), true});
+        return;
+    }
+    // Larger root first, the other from the product to avoid cancellation
+    T r1 = -half - std::copysign(std::sqrt(disc), half);
+    T r2 = r1 != 0 ? q / r1 : 0;
+    roots.push_back({std::complex<T>(r1, 0), false});
+    roots.push_back({std::complex<T>(r2, 0), false});
+}
+
+/**
+ * \brief Multiplies out root factors (1 - r z^-1) into a monic polynomial in z^-1.
+ *
+ * \param roots At most two roots (a pair counts as two).
+ * \param c1 Output coefficient of z^-1.
+ * \param c2 Output coefficient of z^-2.
+ */
+template <typename T>
+void rootsToQuadratic(const std::vector<RootGroup<T>>& roots, T& c1, T& c2) {
+    c1 = 0;
+    c2 = 0;
+    if (roots.size() == 1 && roots[0].pair) {
+        c1 = -2 * roots[0].value.real();
+        c2 = std::norm(roots[0].value);
+    } else if (roots.size() == 1) {
+        c1 = -roots[0].value.real();
+    } else if (roots.size() == 2) {
+        c1 = -(roots[0].value.real() + roots[1].value.real());
+        c2 = roots[0].value.real() * roots[1].value.real();
+    }
+}
+
+/**
+ * \brief Full linear convolution of two coefficient vectors.
+ *
+ * \param x First vector.
+ * \param y Second vector.
+ *
+ * \return Vector of x.size() + y.size() - 1 coefficients.
+ */
+template <typename T>
+std::vector<T> convolve(const std::vector<T>& x, const std::vector<T>& y) {
+    std::vector<T> result(x.size() + y.size() - 1, static_cast<T>(0));
+    for (size_t i = 0; i < x.size(); i++) {
+        for (size_t j = 0; j < y.size(); j++) {
+            result[i + j] += x[i] * y[j];
+        }
+    }
+    return result;
+}
+}  // namespace detail
+
+/**
+ * \brief Rewrites a FilterChain into a cheaper equivalent.
+ *
+ * Chains assembled from configuration often contain redundant stages. The
+ * optimizer flattens nested chains and then treats every run of linear
+ * stages (DynamicGain, DynamicFirFilter, DynamicIirFilter, DynamicSosFilter)
+ * between other stage types as one transfer function, which it rebuilds as:
+ *
+ * - FIR stages convolved into one kernel whenever the fused kernel costs
+ *   fewer multiply-accumulates than the cascade (otherwise kept separate),
+ *   with trailing zero taps trimmed; IIR stages without poles stay in that
+ *   unpadded form unless they are fused with a FIR stage;
+ * - all first- and second-order IIR stages as one DynamicSosFilter whose
+ *   poles are paired with their nearest zeros and whose sections are ordered
+ *   from the poles farthest from the unit circle to the closest, which keeps
+ *   intermediate gains bounded (a single section stays a DynamicIirFilter);
+ * - higher-order IIR stages, and SOS filters with a section whose b0 is
+ *   zero (a leading delay), unchanged;
+ * - all scalar gains folded into the coefficients of the first of those.
+ *
+ * Identity stages (unit gains, single unit taps, sections without poles or
+ * zeros) disappear. A run is only replaced if the rebuilt stages cost fewer
+ * multiply-accumulates (see cost()), otherwise its original stages are kept.
+ * Stages of any other type are kept in place, and linear stages are never
+ * moved across them. Linear stages start with a cleared state, so optimize
+ * a chain before processing with it.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class ChainOptimizer {
+   private:
+    /// \brief Stage description used while rewriting
+    struct Node {
+        /// @brief Stage categories
+        enum class Kind { Gain, Fir, Sections, Iir, Other };
+        /// @brief Stage category
+        Kind kind;
+        /// @brief Gain factor (Gain)
+        T gain = 1;
+        /// @brief Taps (Fir) or feedforward coefficients (Iir)
+        std::vector<T> b;
+        /// @brief Feedback coefficients (Iir)
+        std::vector<T> a;
+        /// @brief Sections (Sections)
+        std::vector<Biquad<T>> sections;
+        /// @brief Taps came from an IIR stage without poles (Fir)
+        bool direct = false;
+        /// @brief Original stage (kept as it is for Other)
+        std::unique_ptr<DynamicFilter<T>> stage;
+
+        /// @brief Creates an empty node of a category
+        explicit Node(Kind category) : kind(category) {}
+    };
+
+    /// \brief Magnitude at or below which a coefficient counts as zero
+    T m_tolerance;
+
+    /**
+     * \brief Removes trailing (near-)zero coefficients.
+     *
+     * \param values Coefficients to trim.
+     */
+    void trim(std::vector<T>& values) const {
+        while (!values.empty() && std::abs(values.back()) <= m_tolerance) {
+            values.pop_back();
+        }
+    }
+
+    /**
+     * \brief Describes a FIR kernel, turning trivial ones into gains.
+     *
+     * \param taps FIR coefficients.
+     *
+     * \return Fir or Gain node.
+     */
+    Node firNode(std::vector<T> taps) const {
+        trim(taps);
+        Node node(Node::Kind::Gain);
+        if (taps.size() <= 1) {
+            node.gain = taps.empty() ? static_cast<T>(0) : taps[0];
+        } else {
+            node.kind = Node::Kind::Fir;
+            node.b = std::move(taps);
+        }
+        return node;
+    }
+
+    /**
+     * \brief Moves the stages of a chain into a flat node list.
+     *
+     * \param chain Chain to empty.
+     * \param nodes Output node list.
+     */
+    void flatten(FilterChain<T>& chain, std::vector<Node>& nodes) const {
+        while (!chain.empty()) {
+            std::unique_ptr<DynamicFilter<T>> stage = chain.remove(0);
+            if (auto* nested = dynamic_cast<FilterChain<T>*>(stage.get())) {
+                flatten(*nested, nodes);
+                continue;
+            }
+            Node node(Node::Kind::Other);
+            if (auto* gain = dynamic_cast<DynamicGain<T>*>(stage.get())) {
+                node.kind = Node::Kind::Gain;
+                node.gain = gain->getGain();
+            } else if (auto* fir = dynamic_cast<DynamicFirFilter<T>*>(stage.get())) {
+                node = firNode(fir->getFactors());
+            } else if (auto* iir = dynamic_cast<DynamicIirFilter<T>*>(stage.get())) {
+                std::vector<T> b = iir->getBFactors();
+                std::vector<T> a = iir->getAFactors();
+                trim(b);
+                trim(a);
+                if (a.empty()) {
+                    node = firNode(std::move(b));
+                    node.direct = true;
+                } else if (!b.empty() && b.size() <= 3 && a.size() <= 2 && std::abs(b[0]) > m_tolerance) {
+                    node.kind = Node::Kind::Sections;
+                    b.resize(3, static_cast<T>(0));
+                    a.resize(2, static_cast<T>(0));
+                    node.sections.push_back(Biquad<T>{b[0], b[1], b[2], a[0], a[1]});
+                } else {
+                    node.kind = Node::Kind::Iir;
+                    node.b = b.empty() ? std::vector<T>{static_cast<T>(0)} : std::move(b);
+                    node.a = std::move(a);
+                }
+            } else if (auto* sos = dynamic_cast<DynamicSosFilter<T>*>(stage.get())) {
+                std::vector<Biquad<T>> sections = sos->getSections();
+                // Sections with a leading delay (b0 = 0) cannot be made monic, the stage is kept as it is
+                bool monic = std::all_of(sections.begin(), sections.end(), [this](const Biquad<T>& section) {
+                    return std::abs(section.b0) > m_tolerance;
+                });
+                if (monic) {
+                    node.kind = Node::Kind::Sections;
+                    node.sections = std::move(sections);
+                }
+            }
+            node.stage = std::move(stage);
+            nodes.push_back(std::move(node));
+        }
+    }
+
+    /**
+     * \brief Re-pairs the poles and zeros of a section cascade.
+     *
+     * Factors every section, gives each pole pair (closest to the unit circle
+     * first) its nearest zeros, and returns monic sections sorted by
+     * increasing pole radius. Sections without poles and zeros are dropped.
+     *
+     * \param input Sections (b0 must be non-zero).
+     * \param gain Multiplied by the product of all b0.
+     *
+     * \return Monic sections in processing order.
+     */
+    static std::vector<Biquad<T>> pairSections(const std::vector<Biquad<T>>& input, T& gain) {
+        using Group = detail::RootGroup<T>;
+        std::vector<Group> zeros;
+        std::vector<Group> poles;
+        for (const Biquad<T>& section : input) {
+            gain *= section.b0;
+            if (section.b2 != 0) {
+                detail::quadraticRoots(section.b1 / section.b0, section.b2 / section.b0, zeros);
+            } else if (section.b1 != 0) {
+                zeros.push_back({std::complex<T>(-section.b1 / section.b0, 0), false});
+            }
+            if (section.a2 != 0) {
+                detail::quadraticRoots(section.a1, section.a2, poles);
+            } else if (section.a1 != 0) {
+                poles.push_back({std::complex<T>(-section.a1, 0), false});
+            }
+        }
+
+        // Pole slots: every complex pair alone, real poles two by two by magnitude
+        struct Slot {
+            std::vector<Group> poles;
+            std::vector<Group> zeros;
+            T radius;
+        };
+        std::vector<Slot> slots;
+        std::vector<Group> realPoles;
+        for (const Group& pole : poles) {
+            if (pole.pair) {
+                slots.push_back({{pole}, {}, std::abs(pole.value)});
+            } else {
+                realPoles.push_back(pole);
+            }
+        }
+        std::sort(realPoles.begin(), realPoles.end(),
+                  [](const Group& x, const Group& y) { return std::abs(x.value) > std::abs(y.value); });
+        for (size_t i = 0; i < realPoles.size(); i += 2) {
+            Slot slot{{realPoles[i]}, {}, std::abs(realPoles[i].value)};
+            if (i + 1 < realPoles.size()) {
+                slot.poles.push_back(realPoles[i + 1]);
+            }
+            slots.push_back(std::move(slot));
+        }
+        std::sort(slots.begin(), slots.end(), [](const Slot& x, const Slot& y) { return x.radius > y.radius; });
+
+        // Nearest zeros for the poles closest to the unit circle first
+        std::vector<bool> used(zeros.size(), false);
+        auto nearest = [&](std::complex<T> target, bool realOnly) {
+            size_t best = zeros.size();
+            for (size_t z = 0; z < zeros.size(); z++) {
+                if (used[z] || (realOnly && zeros[z].pair)) {
+                    continue;
+                }
+                if (best == zeros.size() || std::abs(zeros[z].value - target) < std::abs(zeros[best].value - target)) {
+                    best = z;
+                }
+            }
+            return best;
+        };
+        for (Slot& slot : slots) {
+            size_t first = nearest(slot.poles[0].value, false);
+            if (first == zeros.size()) {
+                continue;
+            }
+            used[first] = true;
+            slot.zeros.push_back(zeros[first]);
+            bool secondOrder = slot.poles.size() == 2 || slot.poles[0].pair;
+            if (!zeros[first].pair && secondOrder) {
+                size_t second = nearest(slot.poles.back().value, true);
+                if (second != zeros.size()) {
+                    used[second] = true;
+                    slot.zeros.push_back(zeros[second]);
+                }
+            }
+        }
+
+        // Remaining zeros form pole-free sections placed first
+        std::vector<Slot> ordered;
+        std::vector<Group> realZeros;
+        for (size_t z = 0; z < zeros.size(); z++) {
+            if (used[z]) {
+                continue;
+            }
+            if (zeros[z].pair) {
+                ordered.push_back({{}, {zeros[z]}, static_cast<T>(0)});
+            } else {
+                realZeros.push_back(zeros[z]);
+            }
+        }
+        for (size_t i = 0; i < realZeros.size(); i += 2) {
+            Slot slot{{}, {realZeros[i]}, static_cast<T>(0)};
+            if (i + 1 < realZeros.size()) {
+                slot.zeros.push_back(realZeros[i + 1]);
+            }
+            ordered.push_back(std::move(slot));
+        }
+        ordered.insert(ordered.end(), slots.rbegin(), slots.rend());
+
+        std::vector<Biquad<T>> sections;
+        for (const Slot& slot : ordered) {
+            Biquad<T> section;
+            detail::rootsToQuadratic(slot.zeros, section.b1, section.b2);
+            detail::rootsToQuadratic(slot.poles, section.a1, section.a2);
+            if (!(section == Biquad<T>{})) {
+                sections.push_back(section);
+            }
+        }
+        return sections;
+    }
+
+    /**
+     * \brief Multiply-accumulates per sample of a FIR kernel.
+     *
+     * \param taps Number of taps.
+     * \param direct true for an IIR stage without poles, false for a padded FIR stage.
+     *
+     * \return Multiply-accumulates per sample.
+     */
+    static size_t kernelCost(size_t taps, bool direct) { return direct ? taps : paddedLength<T>(taps); }
+
+    /**
+     * \brief Rebuilds one run of linear nodes.
+     *
+     * \param begin First node of the run.
+     * \param end Past-the-end node of the run.
+     * \param chain Chain to append the rebuilt stages to.
+     */
+    void rebuild(typename std::vector<Node>::iterator begin, typename std::vector<Node>::iterator end,
+                 FilterChain<T>& chain) const {
+        T gain = 1;
+        std::vector<std::vector<T>> firs;
+        std::vector<bool> direct;
+        std::vector<Biquad<T>> sections;
+        std::vector<Node*> iirs;
+        for (auto node = begin; node != end; ++node) {
+            switch (node->kind) {
+                case Node::Kind::Gain:
+                    gain *= node->gain;
+                    break;
+                case Node::Kind::Fir:
+                    if (!firs.empty() &&
+                        kernelCost(firs.back().size() + node->b.size() - 1, direct.back() && node->direct) <=
+                            kernelCost(firs.back().size(), direct.back()) + kernelCost(node->b.size(), node->direct)) {
+                        firs.back() = detail::convolve(firs.back(), node->b);
+                        trim(firs.back());
+                        direct.back() = direct.back() && node->direct;
+                    } else {
+                        firs.push_back(node->b);
+                        direct.push_back(node->direct);
+                    }
+                    break;
+                case Node::Kind::Sections:
+                    sections.insert(sections.end(), node->sections.begin(), node->sections.end());
+                    break;
+                default:
+                    iirs.push_back(&*node);
+                    break;
+            }
+        }
+        if (!sections.empty()) {
+            sections = pairSections(sections, gain);
+        }
+
+        bool folded = false;
+        if (!firs.empty()) {
+            for (T& tap : firs.front()) {
+                tap *= gain;
+            }
+            folded = true;
+        } else if (!sections.empty()) {
+            sections.front().b0 *= gain;
+            sections.front().b1 *= gain;
+            sections.front().b2 *= gain;
+            folded = true;
+        } else if (!iirs.empty()) {
+            for (T& b : iirs.front()->b) {
+                b *= gain;
+            }
+            folded = true;
+        }
+        if (!folded && std::abs(gain - 1) > m_tolerance) {
+            chain.template emplace<DynamicGain<T>>(gain);
+        }
+
+        for (size_t i = 0; i < firs.size(); i++) {
+            if (direct[i]) {
+                chain.template emplace<DynamicIirFilter<T>>(firs[i], std::vector<T>());
+            } else {
+                chain.template emplace<DynamicFirFilter<T>>(firs[i]);
+            }
+        }
+        if (sections.size() == 1) {
+            // A single section is cheaper as a plain IIR stage with only its non-zero orders
+            const Biquad<T>& q = sections.front();
+            std::vector<T> b{q.b0, q.b1, q.b2};
+            std::vector<T> a{q.a1, q.a2};
+            trim(b);
+            trim(a);
+            chain.template emplace<DynamicIirFilter<T>>(b.empty() ? std::vector<T>{static_cast<T>(0)} : b, a);
+        } else if (!sections.empty()) {
+            chain.template emplace<DynamicSosFilter<T>>(sections);
+        }
+        for (Node* iir : iirs) {
+            chain.template emplace<DynamicIirFilter<T>>(iir->b, iir->a);
+        }
+    }
+
+    /**
+     * \brief Appends one run of linear nodes to a chain, rebuilt if that is cheaper.
+     *
+     * \param begin First node of the run.
+     * \param end Past-the-end node of the run.
+     * \param chain Chain to append to.
+     */
+    void rewrite(typename std::vector<Node>::iterator begin, typename std::vector<Node>::iterator end,
+                 FilterChain<T>& chain) const {
+        size_t original = 0;
+        for (auto node = begin; node != end; ++node) {
+            original += cost(*node->stage);
+        }
+        FilterChain<T> rebuilt;
+        rebuild(begin, end, rebuilt);
+        if (cost(rebuilt) < original) {
+            while (!rebuilt.empty()) {
+                chain.add(rebuilt.remove(0));
+            }
+            return;
+        }
+        for (auto node = begin; node != end; ++node) {
+            node->stage->reset();
+            chain.add(std::move(node->stage));
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates an optimizer.
+     *
+     * \param tolerance Coefficients with magnitude <= tolerance count as zero
+     *                  and gains within tolerance of 1 as identity (0 = exact).
+     */
+    explicit ChainOptimizer(T tolerance = 0) : m_tolerance(tolerance) {}
+
+    /**
+     * \brief Optimizes a chain in place.
+     *
+     * \param chain Chain to rewrite (stage states are cleared).
+     *
+     * \return Stage counts and multiply-accumulates per sample before and after.
+     */
+    ChainReport optimize(FilterChain<T>& chain) const {
+        ChainReport report;
+        report.stagesBefore = chain.size();
+        report.costBefore = cost(chain);
+
+        std::vector<Node> nodes;
+        flatten(chain, nodes);
+        auto runBegin = nodes.begin();
+        for (auto node = nodes.begin(); node != nodes.end(); ++node) {
+            if (node->kind == Node::Kind::Other) {
+                rewrite(runBegin, node, chain);
+                chain.add(std::move(node->stage));
+                runBegin = node + 1;
+            }
+        }
+        rewrite(runBegin, nodes.end(), chain);
+
+        report.stagesAfter = chain.size();
+        report.costAfter = cost(chain);
+        return report;
+    }
+
+    /**
+     * \brief Estimates the multiply-accumulates per sample of a stage.
+     *
+     * FIR stages count their SIMD-padded length, which is what the block
+     * kernel evaluates. Stages of unknown type count 0.
+     *
+     * \param stage Stage to estimate.
+     *
+     * \return Multiply-accumulates per sample.
+     */
+    static size_t cost(const DynamicFilter<T>& stage) {
+        if (auto* chain = dynamic_cast<const FilterChain<T>*>(&stage)) {
+            size_t total = 0;
+            for (size_t i = 0; i < chain->size(); i++) {
+                total += cost(chain->stage(i));
+            }
+            return total;
+        }
+        if (dynamic_cast<const DynamicGain<T>*>(&stage) != nullptr) {
+            return 1;
+        }
+        if (auto* fir = dynamic_cast<const DynamicFirFilter<T>*>(&stage)) {
+            return paddedLength<T>(fir->size());
+        }
+        if (auto* iir = dynamic_cast<const DynamicIirFilter<T>*>(&stage)) {
+            return iir->numB() + iir->numA();
+        }
+        if (auto* sos = dynamic_cast<const DynamicSosFilter<T>*>(&stage)) {
+            return 5 * sos->numSections();
+        }
+        return 0;
+    }
+};
+}  // namespace md
@@ -0,0 +1,377 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "DynamicFirFilter.hpp"
+#include "Fft.hpp"
+#include "ScratchArena.hpp"
+
+namespace md {
+namespace detail {
+/**
+ * \brief Evaluates exp(-i * pi * t) with t reduced to [0, 2) in extended precision.
+ *
+ * \param t Phase in half turns.
+ *
+ * \return Unit phasor.
+ */
+template <typename T>
+std::complex<T> halfTurnPhasor(long double t) {
+    t -= 2.0L * std::floor(t / 2.0L);
+    long double angle = -3.141592653589793238462643383279502884L * t;
+    return std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+}
+}  // namespace detail
+
+/**
+ * \brief Chirp-Z transform on the unit circle (Bluestein algorithm).
+ *
+ * Computes outputLength spectrum values of an inputLength signal at
+ * arbitrary, equally spaced frequencies:
+ * X[k] = sum x[n] * exp(-2*pi*i * (startFreq + k * stepFreq) * n),
+ * with frequencies normalized to the sample rate. Writing n*k as
+ * (n^2 + k^2 - (k-n)^2) / 2 turns the sum into a convolution with a chirp,
+ * evaluated with power-of-two FFTs of length >= inputLength + outputLength - 1.
+ * A narrow band is thus resolved at any spacing for O((N + M) log(N + M))
+ * instead of a zero-padded FFT of 1 / stepFreq points, and dft() gives fast
+ * transforms of any length, including primes.
+ *
+ * The chirp tables and the transformed kernel are computed once. Transforms
+ * take their work buffer from the calling thread's ScratchArena, so forward()
+ * is const and may run concurrently.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class ChirpZ {
+   private:
+    /// \brief Number of input samples
+    size_t m_inputLength = 0;
+    /// \brief Number of output values
+    size_t m_outputLength = 0;
+    /// \brief First output frequency (cycles per sample)
+    long double m_startFreq = 0;
+    /// \brief Output frequency spacing (cycles per sample)
+    long double m_stepFreq = 0;
+    /// \brief Convolution transform
+    Fft<T> m_fft;
+    /// \brief Input weights exp(-2*pi*i*startFreq*n) * chirp(n)
+    std::vector<std::complex<T>> m_pre;
+    /// \brief Output weights chirp(k)
+    std::vector<std::complex<T>> m_post;
+    /// \brief Transform of the conjugate chirp, wrapped for circular convolution
+    std::vector<std::complex<T>> m_kernel;
+
+    /// @brief Smallest power of two >= n
+    static size_t powerOfTwo(size_t n) {
+        size_t size = 1;
+        while (size < n) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    /// @brief Chirp exp(-i * pi * stepFreq * m^2)
+    std::complex<T> chirp(size_t m) const {
+        long double square = static_cast<long double>(m) * static_cast<long double>(m);
+        return detail::halfTurnPhasor<T>(m_stepFreq * square);
+    }
+
+    /**
+     * \brief Computes all tables.
+     *
+     * \throws std::invalid_argument if a length is 0.
+     */
+    void initialize() {
+        if (m_inputLength == 0 || m_outputLength == 0) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        const size_t size = m_fft.size();
+        m_pre.resize(m_inputLength);
+        for (size_t n = 0; n < m_inputLength; n++) {
+            m_pre[n] = detail::halfTurnPhasor<T>(2.0L * m_startFreq * static_cast<long double>(n)) * chirp(n);
+        }
+        m_post.resize(m_outputLength);
+        for (size_t k = 0; k < m_outputLength; k++) {
+            m_post[k] = chirp(k);
+        }
+        m_kernel.assign(size, std::complex<T>(0, 0));
+        for (size_t m = 0; m < m_outputLength; m++) {
+            m_kernel[m] = std::conj(chirp(m));
+        }
+        for (size_t m = 1; m < m_inputLength; m++) {
+            m_kernel[size - m] = std::conj(chirp(m));
+        }
+        m_fft.forward(m_kernel.data());
+    }
+
+    /// @brief Convolves the weighted input in work with the chirp and writes the output
+    void finish(std::complex<T>* work, std::complex<T>* output) const {
+        const size_t size = m_fft.size();
+        std::fill(work + m_inputLength, work + size, std::complex<T>(0, 0));
+        m_fft.forward(work);
+        for (size_t i = 0; i < size; i++) {
+            work[i] *= m_kernel[i];
+        }
+        m_fft.inverse(work);
+        for (size_t k = 0; k < m_outputLength; k++) {
+            output[k] = work[k] * m_post[k];
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a transform.
+     *
+     * Frequencies are taken in extended precision, which keeps the chirp
+     * phases of long transforms accurate.
+     *
+     * \param inputLength Number of input samples (N).
+     * \param outputLength Number of output values (M).
+     * \param startFreq Frequency of output 0, normalized to the sample rate.
+     * \param stepFreq Spacing of the outputs, normalized to the sample rate.
+     *
+     * \throws std::invalid_argument if a length is 0.
+     */
+    ChirpZ(size_t inputLength, size_t outputLength, long double startFreq, long double stepFreq)
+        : m_inputLength(inputLength),
+          m_outputLength(outputLength),
+          m_startFreq(startFreq),
+          m_stepFreq(stepFreq),
+          m_fft(powerOfTwo(std::max<size_t>(inputLength + outputLength, 2) - 1)) {
+        initialize();
+    }
+
+    /**
+     * \brief Creates a transform of a frequency band.
+     *
+     * \param inputLength Number of input samples.
+     * \param outputLength Number of output values (>= 2).
+     * \param lowFreq Frequency of the first output, normalized to the sample rate.
+     * \param highFreq Frequency of the last output, normalized to the sample rate.
+     *
+     * \return Transform with outputs spread evenly from lowFreq to highFreq.
+     *
+     * \throws std::invalid_argument if outputLength < 2 or inputLength is 0.
+     */
+    static ChirpZ band(size_t inputLength, size_t outputLength, T lowFreq, T highFreq) {
+        if (outputLength < 2) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        long double step = (static_cast<long double>(highFreq) - lowFreq) / static_cast<long double>(outputLength - 1);
+        return ChirpZ(inputLength, outputLength, static_cast<long double>(lowFreq), step);
+    }
+
+    /**
+     * \brief Creates a discrete Fourier transform of any length.
+     *
+     * \param size Transform length (any positive integer, e.g. a prime).
+     *
+     * \return Transform with X[k] = sum x[n] * exp(-2*pi*i*k*n/size).
+     *
+     * \throws std::invalid_argument if size is 0.
+     */
+    static ChirpZ dft(size_t size) {
+        if (size == 0) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        return ChirpZ(size, size, 0.0L, 1.0L / static_cast<long double>(size));
+    }
+
+    /**
+     * \brief Transforms a complex signal.
+     *
+     * \param input inputLength() samples.
+     * \param output Output of outputLength() values.
+     */
+    void forward(const std::complex<T>* input, std::complex<T>* output) const {
+        ScratchScope scratch;
+        std::complex<T>* work = scratch.allocate<std::complex<T>>(m_fft.size());
+        for (size_t n = 0; n < m_inputLength; n++) {
+            work[n] = input[n] * m_pre[n];
+        }
+        finish(work, output);
+    }
+
+    /**
+     * \brief Transforms a real signal.
+     *
+     * \param input inputLength() samples.
+     * \param output Output of outputLength() values.
+     */
+    void forward(const T* input, std::complex<T>* output) const {
+        ScratchScope scratch;
+        std::complex<T>* work = scratch.allocate<std::complex<T>>(m_fft.size());
+        for (size_t n = 0; n < m_inputLength; n++) {
+            work[n] = input[n] * m_pre[n];
+        }
+        finish(work, output);
+    }
+
+    /// @brief Gets frequency of an output
+    /// @param k Output index
+    /// @return Frequency normalized to the sample rate
+    T frequency(size_t k) const { return static_cast<T>(m_startFreq + m_stepFreq * static_cast<long double>(k)); }
+
+    /// @brief Gets number of input samples
+    /// @return N
+    size_t inputLength() const { return m_inputLength; }
+
+    /// @brief Gets number of output values
+    /// @return M
+    size_t outputLength() const { return m_outputLength; }
+
+    /// @brief Gets length of the internal FFTs
+    /// @return Power of two >= N + M - 1
+    size_t fftSize() const { return m_fft.size(); }
+};
+
+/**
+ * \brief Zoom FFT: high-resolution spectrum of a band around a center frequency.
+ *
+ * Shifts the band to DC, low-pass filters and decimates by D, then takes an
+ * fftSize-point FFT of the decimated complex signal. The result is fftSize
+ * bins spaced 1 / (fftSize * D) apart, covering centerFreq +- 1 / (2 * D),
+ * for the cost of fftSize decimation outputs and one small FFT instead of an
+ * FFT of fftSize * D points.
+ *
+ * Mixing is folded into the filter: with h the real low-pass taps and
+ * w = 2*pi*centerFreq, output m at input position p is
+ * exp(-i*w*p) * sum h[j] * exp(i*w*j) * x[p-j], so only the kept outputs are
+ * computed (as in a polyphase decimator) and no full-rate oscillator runs.
+ * The low-pass is the windowed-sinc design of DynamicFirFilter::setupLowPass
+ * with cutoff 1 / (2 * D), so bins near the band edges are attenuated and
+ * aliased by the filter's transition band. Longer filters narrow it.
+ *
+ * The bins equal the DFT of the decimated baseband samples (times an optional
+ * window), in ascending frequency order.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class ZoomFft {
+   private:
+    /// \brief Number of output bins (power of two)
+    size_t m_fftSize = 0;
+    /// \brief Decimation factor
+    size_t m_decimation = 0;
+    /// \brief Center frequency (cycles per sample)
+    T m_centerFreq = 0;
+    /// \brief Number of filter taps
+    size_t m_numTaps = 0;
+    /// \brief Real part of the modulated taps, time-reversed
+    AlignedBuffer<T> m_tapsRe;
+    /// \brief Imaginary part of the modulated taps, time-reversed
+    AlignedBuffer<T> m_tapsIm;
+    /// \brief Demodulation phase of every decimated output times the window
+    std::vector<std::complex<T>> m_phase;
+    /// \brief Transform of the decimated block
+    Fft<T> m_fft;
+
+    /// @brief Recomputes the output phases with a window (empty for rectangular)
+    void setPhases(const std::vector<T>& window) {
+        m_phase.resize(m_fftSize);
+        for (size_t m = 0; m < m_fftSize; m++) {
+            long double position = static_cast<long double>(m * m_decimation + m_numTaps - 1);
+            m_phase[m] = detail::halfTurnPhasor<T>(2.0L * static_cast<long double>(m_centerFreq) * position);
+            if (!window.empty()) {
+                m_phase[m] *= window[m];
+            }
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a zoom transform.
+     *
+     * \param fftSize Number of output bins (power of two).
+     * \param decimation Decimation factor D (>= 2), the zoom factor.
+     * \param centerFreq Center of the band, normalized to the sample rate.
+     * \param numTaps Number of low-pass taps (about 8 * D or more for a flat band).
+     *
+     * \throws std::invalid_argument if fftSize is not a power of two, decimation < 2 or numTaps is 0.
+     */
+    ZoomFft(size_t fftSize, size_t decimation, T centerFreq, size_t numTaps)
+        : m_fftSize(fftSize), m_decimation(decimation), m_centerFreq(centerFreq), m_numTaps(numTaps), m_fft(fftSize) {
+        if (decimation < 2 || numTaps == 0) {
+            throw std::invalid_argument("Invalid zoom parameters!");
+        }
+        DynamicFirFilter<T> lowPass(numTaps);
+        lowPass.setupLowPass(static_cast<T>(0.5) / static_cast<T>(decimation));
+        std::vector<T> taps = lowPass.getFactors();
+        m_tapsRe.resize(numTaps);
+        m_tapsIm.resize(numTaps);
+        for (size_t j = 0; j < numTaps; j++) {
+            std::complex<T> rotation =
+                detail::halfTurnPhasor<T>(-2.0L * static_cast<long double>(centerFreq) * static_cast<long double>(j));
+            m_tapsRe[numTaps - 1 - j] = taps[j] * rotation.real();
+            m_tapsIm[numTaps - 1 - j] = taps[j] * rotation.imag();
+        }
+        setPhases(std::vector<T>());
+    }
+
+    /**
+     * \brief Sets a window applied to the decimated samples before the FFT.
+     *
+     * \param window fftSize() weights, or empty for a rectangular window.
+     *
+     * \throws std::invalid_argument if the size is neither 0 nor fftSize().
+     */
+    void setWindow(const std::vector<T>& window) {
+        if (!window.empty() && window.size() != m_fftSize) {
+            throw std::invalid_argument("Bad array!");
+        }
+        setPhases(window);
+    }
+
+    /**
+     * \brief Computes the zoomed spectrum of a real signal.
+     *
+     * \param input inputLength() samples.
+     * \param output Output of fftSize() bins in ascending frequency order.
+     */
+    void forward(const T* input, std::complex<T>* output) const {
+        const T* tapsRe = m_tapsRe.data();
+        const T* tapsIm = m_tapsIm.data();
+        for (size_t m = 0; m < m_fftSize; m++) {
+            const T* x = input + m * m_decimation;
+            T re = static_cast<T>(0.0);
+            T im = static_cast<T>(0.0);
+            for (size_t i = 0; i < m_numTaps; i++) {
+                re += tapsRe[i] * x[i];
+                im += tapsIm[i] * x[i];
+            }
+            output[m] = std::complex<T>(re, im) * m_phase[m];
+        }
+        // Multiplying by (-1)^m moves bin fftSize/2 (the lowest frequency) to index 0
+        for (size_t m = 1; m < m_fftSize; m += 2) {
+            output[m] = -output[m];
+        }
+        m_fft.forward(output);
+    }
+
+    /// @brief Gets frequency of a bin
+    /// @param k Bin index (0 <= k < fftSize())
+    /// @return Frequency normalized to the input sample rate
+    T frequency(size_t k) const {
+        return m_centerFreq + (static_cast<T>(k) - static_cast<T>(m_fftSize / 2)) /
+                                  (static_cast<T>(m_fftSize) * static_cast<T>(m_decimation));
+    }
+
+    /// @brief Gets number of input samples consumed by forward()
+    /// @return (fftSize - 1) * decimation + numTaps
+    size_t inputLength() const { return (m_fftSize - 1) * m_decimation + m_numTaps; }
+
+    /// @brief Gets number of output bins
+    /// @return fftSize
+    size_t fftSize() const { return m_fftSize; }
+
+    /// @brief Gets decimation factor
+    /// @return D
+    size_t decimation() const { return m_decimation; }
+};
+}  // namespace md
@@ -0,0 +1,292 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "Fft.hpp"
+#include "ThreadPool.hpp"
+#include "Window.hpp"
+
+namespace md {
+/**
+ * \brief Multichannel cross-spectral density and coherence (Welch method).
+ *
+ * Estimates the C x C cross-spectral matrix S_ij(f) of a multichannel
+ * recording by averaging windowed, overlapping segments. Every channel is
+ * transformed only once per segment; the matrix is then accumulated as a
+ * Hermitian outer product X X^H of the segment spectra, of which only the
+ * upper triangle is computed. The accumulation is blocked over channel pairs
+ * and bins so the spectra of a block stay in L1, and the bin loop is a
+ * vectorized multiply-add over split real/imaginary arrays.
+ *
+ * Segments are distributed over a ThreadPool. Each worker accumulates a
+ * private partial matrix, and the partials are summed once at the end, so no
+ * synchronization is needed while accumulating.
+ *
+ * \tparam T Data type (must be floating-point).
+ * \tparam Size Segment length and FFT size (must be a power of two).
+ */
+template <typename T, size_t Size>
+class CrossSpectralDensity {
+   private:
+    /// @brief Number of channels per block of the outer product
+    static constexpr size_t kChannelTile = 4;
+    /// @brief Number of bins per block of the outer product
+    static constexpr size_t kBinTile = 64;
+    /// @brief Number of non-redundant bins
+    static constexpr size_t kBins = Size / 2 + 1;
+
+    /// \brief Per-worker buffers
+    struct Worker {
+        /// @brief Real FFT (holds its own work buffer)
+        RealFft<T> fft{Size};
+        /// @brief Windowed segment
+        AlignedBuffer<T> frame;
+        /// @brief Segment spectrum of one channel
+        std::vector<std::complex<T>> spectrum;
+        /// @brief Real parts of all channel spectra, [channel][bin]
+        AlignedBuffer<T> re;
+        /// @brief Imaginary parts of all channel spectra, [channel][bin]
+        AlignedBuffer<T> im;
+        /// @brief Partial sum of the real parts, [pair][bin]
+        AlignedBuffer<T> sumRe;
+        /// @brief Partial sum of the imaginary parts, [pair][bin]
+        AlignedBuffer<T> sumIm;
+    };
+
+    /// \brief Window applied to each segment
+    Window<T, Size> m_window;
+    /// \brief Distance between segment starts
+    size_t m_hop;
+    /// \brief Sampling frequency in Hz
+    T m_sampleRate;
+    /// \brief Worker threads
+    std::unique_ptr<ThreadPool> m_pool;
+    /// \brief Buffers of each worker
+    std::vector<Worker> m_workers;
+    /// \brief Number of channels of the last estimate
+    size_t m_numChannels = 0;
+    /// \brief Number of segments of the last estimate
+    size_t m_segments = 0;
+    /// \brief Estimated densities, real parts, [pair][bin]
+    AlignedBuffer<T> m_re;
+    /// \brief Estimated densities, imaginary parts, [pair][bin]
+    AlignedBuffer<T> m_im;
+
+    /**
+     * \brief Gets the index of channel pair (i, j), i <= j, in the upper triangle.
+     *
+     * \param i Row channel.
+     * \param j Column channel (>= i).
+     *
+     * \return Pair index.
+     */
+    size_t pairIndex(size_t i, size_t j) const { return i * m_numChannels - i * (i - 1) / 2 + (j - i); }
+
+    /**
+     * \brief Adds the outer product of one segment to a worker's partial sums.
+     *
+     * \param worker Worker buffers holding the segment spectra.
+     */
+    void accumulate(Worker& worker) const {
+        const size_t channels = m_numChannels;
+        for (size_t k0 = 0; k0 < kBins; k0 += kBinTile) {
+            const size_t k1 = std::min(kBins, k0 + kBinTile);
+            for (size_t i0 = 0; i0 < channels; i0 += kChannelTile) {
+                const size_t i1 = std::min(channels, i0 + kChannelTile);
+                for (size_t j0 = i0; j0 < channels; j0 += kChannelTile) {
+                    const size_t j1 = std::min(channels, j0 + kChannelTile);
+                    for (size_t i = i0; i < i1; i++) {
+                        const T* ar = worker.re.data() + i * kBins;
+                        const T* ai = worker.im.data() + i * kBins;
+                        for (size_t j = std::max(i, j0); j < j1; j++) {
+                            const T* br = worker.re.data() + j * kBins;
+                            const T* bi = worker.im.data() + j * kBins;
+                            T* sr = worker.sumRe.data() + pairIndex(i, j) * kBins;
+                            T* si = worker.sumIm.data() + pairIndex(i, j) * kBins;
+                            for (size_t k = k0; k < k1; k++) {
+                                sr[k] += ar[k] * br[k] + ai[k] * bi[k];
+                                si[k] += ai[k] * br[k] - ar[k] * bi[k];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates an estimator.
+     *
+     * \param window Window applied to every segment.
+     * \param hop Distance between segment starts (0 < hop <= Size, Size/2 for 50% overlap).
+     * \param sampleRate Sampling frequency in Hz (used for density scaling).
+     * \param numThreads Number of worker threads (0 = hardware concurrency).
+     *
+     * \throws std::invalid_argument if hop or sampleRate is out of range.
+     */
+    CrossSpectralDensity(const Window<T, Size>& window, size_t hop, T sampleRate, size_t numThreads = 0)
+        : m_window(window), m_hop(hop), m_sampleRate(sampleRate) {
+        if (hop == 0 || hop > Size || sampleRate <= 0) {
+            throw std::invalid_argument("Invalid spectral estimation parameters!");
+        }
+        m_pool = std::make_unique<ThreadPool>(numThreads);
+        m_workers.resize(m_pool->size());
+        for (Worker& worker : m_workers) {
+            worker.frame.resize(Size);
+            worker.spectrum.resize(kBins);
+        }
+    }
+
+    /**
+     * \brief Estimates the cross-spectral matrix of a multichannel signal.
+     *
+     * Uses one-sided density scaling: S_ij(f) = 2 * mean(X_i X_j^*) /
+     * (sampleRate * sum(w^2)), without doubling at DC and Nyquist.
+     *
+     * \param channels numChannels pointers to the channel signals.
+     * \param numChannels Number of channels (C).
+     * \param length Number of samples per channel (>= Size).
+     *
+     * \throws std::invalid_argument if a pointer is nullptr, numChannels is 0 or length < Size.
+     */
+    void compute(const T* const* channels, size_t numChannels, size_t length) {
+        if (channels == nullptr || numChannels == 0 || length < Size) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t c = 0; c < numChannels; c++) {
+            if (channels[c] == nullptr) {
+                throw std::invalid_argument("Bad array!");
+            }
+        }
+        m_numChannels = numChannels;
+        m_segments = (length - Size) / m_hop + 1;
+        const size_t pairs = numChannels * (numChannels + 1) / 2;
+        for (Worker& worker : m_workers) {
+            worker.re.resize(numChannels * kBins);
+            worker.im.resize(numChannels * kBins);
+            worker.sumRe.resize(pairs * kBins);
+            worker.sumIm.resize(pairs * kBins);
+        }
+
+        m_pool->parallelFor(m_segments, [&](size_t chunk, size_t begin, size_t end) {
+            Worker& worker = m_workers[chunk];
+            for (size_t segment = begin; segment < end; segment++) {
+                for (size_t c = 0; c < numChannels; c++) {
+                    const T* start = channels[c] + segment * m_hop;
+                    std::copy(start, start + Size, worker.frame.data());
+                    m_window.process(worker.frame.data(), Size);
+                    worker.fft.forward(worker.frame.data(), worker.spectrum.data());
+                    for (size_t k = 0; k < kBins; k++) {
+                        worker.re[c * kBins + k] = worker.spectrum[k].real();
+                        worker.im[c * kBins + k] = worker.spectrum[k].imag();
+                    }
+                }
+                accumulate(worker);
+            }
+        });
+
+        std::array<T, Size> w = m_window.getFactors();
+        T windowPower = 0;
+        for (size_t n = 0; n < Size; n++) {
+            windowPower += w[n] * w[n];
+        }
+        T scale = static_cast<T>(1.0) / (static_cast<T>(m_segments) * m_sampleRate * windowPower);
+        m_re.resize(pairs * kBins);
+        m_im.resize(pairs * kBins);
+        for (const Worker& worker : m_workers) {
+            for (size_t i = 0; i < pairs * kBins; i++) {
+                m_re[i] += worker.sumRe[i];
+                m_im[i] += worker.sumIm[i];
+            }
+        }
+        for (size_t p = 0; p < pairs; p++) {
+            for (size_t k = 0; k < kBins; k++) {
+                T factor = (k == 0 || k == kBins - 1) ? scale : 2 * scale;
+                m_re[p * kBins + k] *= factor;
+                m_im[p * kBins + k] *= factor;
+            }
+        }
+    }
+
+    /**
+     * \brief Gets one element of the cross-spectral matrix.
+     *
+     * \param i Row channel.
+     * \param j Column channel.
+     * \param bin Frequency bin (frequency = bin * sampleRate / Size).
+     *
+     * \return S_ij at the bin (S_ji is the complex conjugate).
+     *
+     * \throws std::out_of_range if an index is out of range.
+     */
+    std::complex<T> csd(size_t i, size_t j, size_t bin) const {
+        if (i >= m_numChannels || j >= m_numChannels || bin >= kBins) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        if (i > j) {
+            return std::conj(csd(j, i, bin));
+        }
+        size_t index = pairIndex(i, j) * kBins + bin;
+        return std::complex<T>(m_re[index], m_im[index]);
+    }
+
+    /**
+     * \brief Gets the cross-spectral density of a channel pair.
+     *
+     * \param i Row channel.
+     * \param j Column channel.
+     *
+     * \return S_ij for all bins.
+     *
+     * \throws std::out_of_range if a channel index is out of range.
+     */
+    std::vector<std::complex<T>> csd(size_t i, size_t j) const {
+        std::vector<std::complex<T>> result(kBins);
+        for (size_t k = 0; k < kBins; k++) {
+            result[k] = csd(i, j, k);
+        }
+        return result;
+    }
+
+    /**
+     * \brief Gets the magnitude-squared coherence of a channel pair.
+     *
+     * C_ij(f) = |S_ij(f)|^2 / (S_ii(f) * S_jj(f)), in range [0, 1].
+     *
+     * \param i First channel.
+     * \param j Second channel.
+     *
+     * \return Coherence for all bins (0 where a power spectrum is zero).
+     *
+     * \throws std::out_of_range if a channel index is out of range.
+     */
+    std::vector<T> coherence(size_t i, size_t j) const {
+        std::vector<T> result(kBins);
+        for (size_t k = 0; k < kBins; k++) {
+            T pii = csd(i, i, k).real();
+            T pjj = csd(j, j, k).real();
+            T denominator = pii * pjj;
+            result[k] = denominator > 0 ? std::norm(csd(i, j, k)) / denominator : static_cast<T>(0.0);
+        }
+        return result;
+    }
+
+    /// @brief Gets number of channels of the last estimate
+    /// @return C
+    size_t numChannels() const { return m_numChannels; }
+
+    /// @brief Gets number of segments averaged by the last estimate
+    /// @return Number of segments
+    size_t segments() const { return m_segments; }
+
+    /// @brief Gets number of bins
+    /// @return Size/2+1
+    static constexpr size_t bins() { return kBins; }
+};
+}  // namespace md
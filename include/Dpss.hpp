@@ -0,0 +1,406 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "Fft.hpp"
+
+namespace md {
+namespace detail {
+/**
+ * \brief Counts the eigenvalues of a symmetric tridiagonal matrix below a value (Sturm sequence).
+ *
+ * \param diagonal Main diagonal (n values).
+ * \param offSquared Squared off-diagonal, offSquared[i] couples rows i-1 and i (offSquared[0] unused).
+ * \param n Matrix order.
+ * \param x Value to compare with.
+ * \param pivotMin Smallest pivot magnitude (replaces zero pivots).
+ *
+ * \return Number of eigenvalues smaller than x.
+ */
+template <typename R>
+size_t sturmCount(const R* diagonal, const R* offSquared, size_t n, R x, R pivotMin) {
+    size_t count = 0;
+    R q = diagonal[0] - x;
+    for (size_t i = 0;; i++) {
+        if (std::abs(q) < pivotMin) {
+            q = -pivotMin;
+        }
+        count += q < 0 ? 1 : 0;
+        if (i + 1 == n) {
+            return count;
+        }
+        q = diagonal[i + 1] - x - offSquared[i + 1] / q;
+    }
+}
+
+/**
+ * \brief Solves (A - shift * I) x = b for a symmetric tridiagonal A.
+ *
+ * Gaussian elimination with partial pivoting, so shifts at an eigenvalue
+ * (inverse iteration) stay stable. Zero pivots are replaced by pivotMin.
+ *
+ * \param diagonal Main diagonal (n values).
+ * \param off Off-diagonal, off[i] couples rows i-1 and i (off[0] unused).
+ * \param n Matrix order.
+ * \param shift Shift subtracted from the diagonal.
+ * \param pivotMin Smallest pivot magnitude.
+ * \param rhs Right-hand side b, replaced by the solution x.
+ * \param work Work buffer of 3n values.
+ */
+template <typename R>
+void solveShifted(const R* diagonal, const R* off, size_t n, R shift, R pivotMin, R* rhs, R* work) {
+    R* d = work;
+    R* du = work + n;
+    R* du2 = work + 2 * n;
+    for (size_t i = 0; i < n; i++) {
+        d[i] = diagonal[i] - shift;
+        du[i] = i + 1 < n ? off[i + 1] : static_cast<R>(0.0);
+        du2[i] = static_cast<R>(0.0);
+    }
+    for (size_t i = 0; i + 1 < n; i++) {
+        const R sub = off[i + 1];
+        if (std::abs(d[i]) >= std::abs(sub)) {
+            if (std::abs(d[i]) < pivotMin) {
+                d[i] = pivotMin;
+            }
+            R factor = sub / d[i];
+            d[i + 1] -= factor * du[i];
+            rhs[i + 1] -= factor * rhs[i];
+        } else {
+            // Swap rows i and i+1, the new row i gains a second superdiagonal
+            R factor = d[i] / sub;
+            d[i] = sub;
+            R next = d[i + 1];
+            d[i + 1] = du[i] - factor * next;
+            if (i + 2 < n) {
+                du2[i] = du[i + 1];
+                du[i + 1] = -factor * du2[i];
+            }
+            du[i] = next;
+            R b = rhs[i];
+            rhs[i] = rhs[i + 1];
+            rhs[i + 1] = b - factor * rhs[i + 1];
+        }
+    }
+    if (std::abs(d[n - 1]) < pivotMin) {
+        d[n - 1] = pivotMin;
+    }
+    for (size_t i = n; i-- > 0;) {
+        R value = rhs[i];
+        if (i + 1 < n) {
+            value -= du[i] * rhs[i + 1];
+        }
+        if (i + 2 < n) {
+            value -= du2[i] * rhs[i + 2];
+        }
+        rhs[i] = value / d[i];
+    }
+}
+}  // namespace detail
+
+/**
+ * \brief Discrete prolate spheroidal (Slepian) sequences.
+ *
+ * The K tapers of length N with time-bandwidth product NW are the sequences
+ * whose energy is most concentrated in the band |f| < W = NW / N. They are
+ * the eigenvectors of the symmetric tridiagonal matrix that commutes with
+ * the concentration problem, diag ((N - 1 - 2n) / 2)^2 cos(2 pi W) and
+ * off-diagonal n (N - n) / 2. The K largest eigenvalues are isolated by
+ * Sturm-sequence bisection and their eigenvectors found by inverse
+ * iteration, which costs O(K N) (plus O(K^2 N) of reorthogonalization)
+ * instead of the O(N^3) of a dense solver.
+ *
+ * Each taper has unit energy. Symmetric tapers (even k) have a positive sum
+ * and antisymmetric ones (odd k) start with a positive lobe. The
+ * concentration ratio lambda_k (fraction of energy inside the band) is
+ * computed from the taper's autocorrelation with one FFT.
+ *
+ * Tapers are immutable and shared: get() computes a set once per
+ * (N, NW, K) and returns the cached set afterwards, from any thread.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class Dpss {
+   private:
+    /// @brief Precision of the eigen-solver (at least double)
+    using Real = typename std::conditional<(sizeof(T) > sizeof(double)), T, double>::type;
+    /// @brief Cache key (length, bandwidth, count)
+    using Key = std::tuple<size_t, T, size_t>;
+    /// @brief Number of inverse iteration steps per taper
+    static constexpr int kInverseIterations = 3;
+
+    /// \brief Taper length N
+    size_t m_length;
+    /// \brief Time-bandwidth product NW
+    T m_bandwidth;
+    /// \brief Number of tapers K
+    size_t m_count;
+    /// \brief Tapers, [taper][sample]
+    AlignedBuffer<T> m_tapers;
+    /// \brief Concentration ratio of each taper
+    std::vector<T> m_concentrations;
+
+    /// @brief Cached taper sets
+    static std::map<Key, std::shared_ptr<const Dpss<T>>>& cache() {
+        static std::map<Key, std::shared_ptr<const Dpss<T>>> tapers;
+        return tapers;
+    }
+
+    /// @brief Lock of the cache
+    static std::mutex& cacheMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /**
+     * \brief Computes a taper set.
+     *
+     * \param length Taper length N.
+     * \param bandwidth Time-bandwidth product NW.
+     * \param count Number of tapers K.
+     */
+    Dpss(size_t length, T bandwidth, size_t count) : m_length(length), m_bandwidth(bandwidth), m_count(count) {
+        const size_t n = length;
+        const Real w = static_cast<Real>(bandwidth) / static_cast<Real>(n);
+        const Real cosine = std::cos(2 * static_cast<Real>(M_PI) * w);
+        std::vector<Real> diagonal(n);
+        std::vector<Real> off(n, 0);
+        std::vector<Real> offSquared(n, 0);
+        for (size_t i = 0; i < n; i++) {
+            Real centered = (static_cast<Real>(n) - 1 - 2 * static_cast<Real>(i)) / 2;
+            diagonal[i] = centered * centered * cosine;
+            if (i > 0) {
+                off[i] = static_cast<Real>(i) * static_cast<Real>(n - i) / 2;
+                offSquared[i] = off[i] * off[i];
+            }
+        }
+
+        // Gershgorin bounds of the spectrum
+        Real low = diagonal[0];
+        Real high = diagonal[0];
+        for (size_t i = 0; i < n; i++) {
+            Real radius = off[i] + (i + 1 < n ? off[i + 1] : 0);
+            low = std::min(low, diagonal[i] - radius);
+            high = std::max(high, diagonal[i] + radius);
+        }
+        const Real eps = std::numeric_limits<Real>::epsilon();
+        const Real norm = std::max(std::abs(low), std::abs(high));
+        const Real pivotMin = std::max(norm * eps * eps, std::numeric_limits<Real>::min());
+
+        m_tapers.resize(count * n);
+        std::vector<Real> basis(count * n);
+        std::vector<Real> vector(n);
+        std::vector<Real> work(3 * n);
+        Real upper = high;
+        for (size_t k = 0; k < count; k++) {
+            // Bisection for the k-th largest eigenvalue, which lies below the previous one
+            const size_t index = n - 1 - k;
+            Real a = low;
+            Real b = upper;
+            while (b - a > 2 * eps * std::max(std::abs(a), std::abs(b)) + pivotMin) {
+                Real middle = a + (b - a) / 2;
+                if (middle <= a || middle >= b) {
+                    break;
+                }
+                if (detail::sturmCount(diagonal.data(), offSquared.data(), n, middle, pivotMin) <= index) {
+                    a = middle;
+                } else {
+                    b = middle;
+                }
+            }
+            const Real eigenvalue = a + (b - a) / 2;
+            upper = eigenvalue;
+
+            // Inverse iteration from a pseudo-random start (not orthogonal to any taper)
+            uint32_t seed = 0x9E3779B9u + static_cast<uint32_t>(k);
+            for (size_t i = 0; i < n; i++) {
+                seed = seed * 1664525u + 1013904223u;
+                vector[i] = static_cast<Real>(seed >> 8) / static_cast<Real>(1u << 24) + static_cast<Real>(0.5);
+            }
+            for (int iteration = 0; iteration < kInverseIterations; iteration++) {
+                detail::solveShifted(diagonal.data(), off.data(), n, eigenvalue, pivotMin, vector.data(),
+                                     work.data());
+                // Remove the components along earlier tapers that roundoff brings in for large N
+                for (size_t j = 0; j < k; j++) {
+                    const Real* previous = basis.data() + j * n;
+                    Real projection = 0;
+                    for (size_t i = 0; i < n; i++) {
+                        projection += previous[i] * vector[i];
+                    }
+                    for (size_t i = 0; i < n; i++) {
+                        vector[i] -= projection * previous[i];
+                    }
+                }
+                Real energy = 0;
+                for (size_t i = 0; i < n; i++) {
+                    energy += vector[i] * vector[i];
+                }
+                Real scale = 1 / std::sqrt(energy);
+                for (size_t i = 0; i < n; i++) {
+                    vector[i] *= scale;
+                }
+            }
+
+            // Sign convention
+            Real sign = 0;
+            if (k % 2 == 0) {
+                for (size_t i = 0; i < n; i++) {
+                    sign += vector[i];
+                }
+            } else {
+                const Real threshold = std::max(static_cast<Real>(1e-7), 1 / static_cast<Real>(n));
+                for (size_t i = 0; i < n && sign == 0; i++) {
+                    sign = vector[i] * vector[i] > threshold ? vector[i] : 0;
+                }
+            }
+            T* taper = m_tapers.data() + k * n;
+            Real* kept = basis.data() + k * n;
+            for (size_t i = 0; i < n; i++) {
+                kept[i] = sign < 0 ? -vector[i] : vector[i];
+                taper[i] = static_cast<T>(kept[i]);
+            }
+        }
+        computeConcentrations(w);
+    }
+
+    /**
+     * \brief Computes the concentration ratios.
+     *
+     * lambda = sum_m r(m) sin(2 pi W m) / (pi m), where r is the
+     * autocorrelation of the taper, obtained with a zero-padded FFT.
+     *
+     * \param w Half bandwidth W in cycles per sample.
+     */
+    void computeConcentrations(Real w) {
+        const size_t n = m_length;
+        size_t size = 2;
+        while (size < 2 * n) {
+            size *= 2;
+        }
+        Fft<Real> fft(size);
+        std::vector<std::complex<Real>> data(size);
+        std::vector<Real> kernel(n);
+        kernel[0] = 2 * w;
+        for (size_t m = 1; m < n; m++) {
+            Real lag = static_cast<Real>(m);
+            kernel[m] = std::sin(2 * static_cast<Real>(M_PI) * w * lag) / (static_cast<Real>(M_PI) * lag);
+        }
+        m_concentrations.resize(m_count);
+        for (size_t k = 0; k < m_count; k++) {
+            const T* taper = m_tapers.data() + k * n;
+            std::fill(data.begin(), data.end(), std::complex<Real>(0));
+            for (size_t i = 0; i < n; i++) {
+                data[i] = std::complex<Real>(static_cast<Real>(taper[i]), 0);
+            }
+            fft.forward(data.data());
+            for (std::complex<Real>& value : data) {
+                value = std::norm(value);
+            }
+            fft.inverse(data.data());
+            // r is even, so positive lags count twice
+            Real concentration = data[0].real() * kernel[0];
+            for (size_t m = 1; m < n; m++) {
+                concentration += 2 * data[m].real() * kernel[m];
+            }
+            m_concentrations[k] = static_cast<T>(std::min<Real>(std::max<Real>(concentration, 0), 1));
+        }
+    }
+
+   public:
+    /**
+     * \brief Gets a taper set, computing it on first use.
+     *
+     * \param length Taper length N (> 0).
+     * \param bandwidth Time-bandwidth product NW (0 < NW < N/2), typically 2 to 4.
+     * \param count Number of tapers K (0 < K <= N), typically 2 * NW - 1.
+     *
+     * \return Shared, immutable taper set.
+     *
+     * \throws std::invalid_argument if a parameter is out of range.
+     */
+    static std::shared_ptr<const Dpss<T>> get(size_t length, T bandwidth, size_t count) {
+        if (length == 0 || !(bandwidth > 0) || !(2 * bandwidth < static_cast<T>(length)) || count == 0 ||
+            count > length) {
+            throw std::invalid_argument("Invalid taper parameters!");
+        }
+        const Key key(length, bandwidth, count);
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex());
+            auto found = cache().find(key);
+            if (found != cache().end()) {
+                return found->second;
+            }
+        }
+        // Computed outside the lock, a concurrent computation of the same set keeps the first result
+        std::shared_ptr<const Dpss<T>> tapers(new Dpss<T>(length, bandwidth, count));
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        return cache().emplace(key, std::move(tapers)).first->second;
+    }
+
+    /// @brief Drops all cached taper sets (sets still in use stay valid)
+    static void clearCache() {
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        cache().clear();
+    }
+
+    /**
+     * \brief Gets one taper.
+     *
+     * \param k Taper index (0 = most concentrated).
+     *
+     * \return Pointer to N samples.
+     *
+     * \throws std::out_of_range if k >= count().
+     */
+    const T* taper(size_t k) const {
+        if (k >= m_count) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        return m_tapers.data() + k * m_length;
+    }
+
+    /**
+     * \brief Gets the concentration ratio of one taper.
+     *
+     * \param k Taper index.
+     *
+     * \return Fraction of the taper's energy in |f| < W, close to 1 for k < 2 * NW - 1.
+     *
+     * \throws std::out_of_range if k >= count().
+     */
+    T concentration(size_t k) const {
+        if (k >= m_count) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        return m_concentrations[k];
+    }
+
+    /// @brief Gets concentration ratios of all tapers
+    /// @return lambda_0, ..., lambda_(K-1)
+    const std::vector<T>& concentrations() const { return m_concentrations; }
+
+    /// @brief Gets taper length
+    /// @return N
+    size_t length() const { return m_length; }
+
+    /// @brief Gets time-bandwidth product
+    /// @return NW
+    T bandwidth() const { return m_bandwidth; }
+
+    /// @brief Gets number of tapers
+    /// @return K
+    size_t count() const { return m_count; }
+};
+}  // namespace md
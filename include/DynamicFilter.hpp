@@ -0,0 +1,74 @@
+#pragma once
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "AlignedBuffer.hpp"
+
+namespace md {
+/**
+ * \brief Abstract base class for digital filters sized at runtime.
+ *
+ * Runtime counterpart of Filter for designs whose number of coefficients is
+ * only known when the program runs. All coefficient and state storage is
+ * allocated when the filter is configured, so process() never allocates.
+ * Derived filters work on whole blocks instead of single samples, which lets
+ * their kernels keep accumulators in registers and vectorize across samples.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class DynamicFilter {
+   public:
+    /**
+     * \brief Resets the filter to its initial state.
+     *
+     * Clears all internal delay lines. Coefficients are not affected.
+     */
+    virtual void reset() = 0;
+
+    /// @brief Pure virtual destructor
+    virtual ~DynamicFilter() = default;
+
+    /**
+     * \brief Processes a signal array in-place.
+     *
+     * Applies the filter to a block of samples. The filter maintains its
+     * internal state across calls, enabling continuous processing of signal.
+     *
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    virtual void process(T* signal, size_t length) = 0;
+
+    /**
+     * \brief Creates a copy of the filter through the base class.
+     *
+     * Allows containers of filters (e.g. FilterChain) to be duplicated, for
+     * example to give every worker thread its own instance.
+     *
+     * \return New filter with the same coefficients and state.
+     */
+    virtual std::unique_ptr<DynamicFilter<T>> clone() const = 0;
+
+    /**
+     * \brief Processes a contiguous signal container in-place.
+     *
+     * Works with any container providing data() and size() (e.g., std::vector,
+     * std::array, Signal), so the whole container is handled as one block.
+     *
+     * \tparam Container Type of contiguous container.
+     * \param signal Signal container to process (modified in-place).
+     */
+    template <typename Container>
+    void process(Container& signal) {
+        process(signal.data(), signal.size());
+    }
+
+   protected:
+    /// @brief Default constructor
+    DynamicFilter() { static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!"); }
+};
+}  // namespace md
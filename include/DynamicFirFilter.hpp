@@ -0,0 +1,341 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "DynamicFilter.hpp"
+#include "FastMath.hpp"
+#include "ScratchArena.hpp"
+
+namespace md {
+namespace detail {
+/// @brief Number of output samples accumulated together by the FIR block kernel
+constexpr size_t kFirTile = 16;
+
+/**
+ * \brief Block FIR kernel over a linear delay line.
+ *
+ * Computes out[j] = sum_{k=first}^{taps-1} coeffs[k] * work[j + k] for
+ * j in [0, count). The coefficients are stored time-reversed, so every output
+ * is a forward dot product over contiguous memory. Outputs are accumulated in
+ * tiles of kFirTile: the inner loop runs across independent outputs, which the
+ * compiler vectorizes without reassociating any sum.
+ *
+ * \param coeffs Time-reversed coefficients (taps elements).
+ * \param first Index of the first non-padding coefficient.
+ * \param taps Number of (padded) coefficients.
+ * \param work Delay line: taps-1 history samples followed by count inputs.
+ * \param out Output array (may alias work + taps - 1).
+ * \param count Number of outputs to compute.
+ */
+template <typename T>
+void firBlockKernel(const T* coeffs, size_t first, size_t taps, const T* work, T* out, size_t count) {
+    size_t j = 0;
+    for (; j + kFirTile <= count; j += kFirTile) {
+        T acc[kFirTile] = {};
+        for (size_t k = first; k < taps; k++) {
+            const T c = coeffs[k];
+            const T* x = work + j + k;
+            for (size_t t = 0; t < kFirTile; t++) {
+                acc[t] += c * x[t];
+            }
+        }
+        for (size_t t = 0; t < kFirTile; t++) {
+            out[j + t] = acc[t];
+        }
+    }
+    for (; j < count; j++) {
+        T acc = static_cast<T>(0.0);
+        for (size_t k = first; k < taps; k++) {
+            acc += coeffs[k] * work[j + k];
+        }
+        out[j] = acc;
+    }
+}
+}  // namespace detail
+
+/**
+ * \brief Finite Impulse Response (FIR) filter sized at runtime.
+ *
+ * Runtime counterpart of FirFilter. The number of coefficients is chosen at
+ * construction (or when new factors are set) and all storage is allocated at
+ * that moment: time-reversed, zero-padded coefficients and a linear delay line
+ * holding Size-1 history samples plus one processing block. process() copies
+ * each block behind the history and evaluates it with a register-tiled kernel,
+ * so no circular indexing or allocation happens on the processing path.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class DynamicFirFilter : public DynamicFilter<T> {
+   private:
+    /// @brief Minimum number of samples processed per kernel call
+    static constexpr size_t kMinBlock = 256;
+
+    /// \brief Number of coefficients
+    size_t m_size = 0;
+    /// \brief Number of coefficients rounded up to SIMD lanes
+    size_t m_padded = 0;
+    /// \brief Number of input samples processed per kernel call
+    size_t m_block = 0;
+    /// \brief Time-reversed coefficients, leading padding is zero
+    AlignedBuffer<T> m_coeffs;
+    /// \brief Linear delay line: m_padded-1 history samples followed by a block
+    AlignedBuffer<T> m_work;
+
+    /**
+     * \brief Accesses coefficient i in natural (non-reversed) order.
+     *
+     * \param i Coefficient index (0 <= i < size()).
+     *
+     * \return Reference to the stored coefficient.
+     */
+    T& tap(size_t i) { return m_coeffs[m_padded - 1 - i]; }
+    /// @brief Const access to coefficient i in natural order
+    /// @param i Coefficient index
+    /// @return Coefficient value
+    T tap(size_t i) const { return m_coeffs[m_padded - 1 - i]; }
+
+    /**
+     * \brief Allocates coefficient and delay line storage for a filter length.
+     *
+     * \param size Number of coefficients.
+     *
+     * \throws std::invalid_argument if size is 0.
+     */
+    void configure(size_t size) {
+        if (size == 0) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        m_size = size;
+        m_padded = paddedLength<T>(size);
+        m_block = std::max(kMinBlock, m_padded);
+        m_coeffs.resize(m_padded);
+        m_work.resize(m_padded - 1 + m_block);
+    }
+
+   public:
+    using DynamicFilter<T>::process;
+
+    /**
+     * \brief Creates a new FIR filter with cleared state.
+     *
+     * Allocates zeroed coefficients and delay line for the given length.
+     * Filter must be configured with a setup method before use.
+     *
+     * \param size Number of coefficients.
+     *
+     * \throws std::invalid_argument if size is 0.
+     */
+    explicit DynamicFirFilter(size_t size) { configure(size); }
+
+    /**
+     * \brief Creates a new FIR filter from existing coefficients.
+     *
+     * \param factors Filter coefficients [h0, h1, ..., h(Size-1)].
+     *
+     * \throws std::invalid_argument if factors is empty.
+     */
+    explicit DynamicFirFilter(const std::vector<T>& factors) { setFactors(factors); }
+
+    /**
+     * \brief Creates a copy of an existing FIR filter.
+     *
+     * Copies the coefficients and delay line from the source filter.
+     *
+     * \param other The source filter to copy from.
+     */
+    DynamicFirFilter(const DynamicFirFilter<T>& other) = default;
+
+    /// @brief Copy assignment operator
+    /// @param other Filter to copy from
+    /// @return Reference to this filter
+    DynamicFirFilter& operator=(const DynamicFirFilter<T>& other) = default;
+
+    /// @brief Creates a copy of the filter
+    /// @return New filter with the same coefficients and state
+    std::unique_ptr<DynamicFilter<T>> clone() const override { return std::make_unique<DynamicFirFilter<T>>(*this); }
+
+    /**
+     * \brief Processes a signal array in-place.
+     *
+     * Splits the signal into blocks, copies each block behind the stored
+     * history and runs the tiled FIR kernel. The last Size-1 inputs are kept
+     * as history for the next call.
+     *
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    void process(T* signal, size_t length) override {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const size_t history = m_padded - 1;
+        T* work = m_work.data();
+        for (size_t pos = 0; pos < length; pos += m_block) {
+            size_t count = std::min(m_block, length - pos);
+            std::copy(signal + pos, signal + pos + count, work + history);
+            detail::firBlockKernel(m_coeffs.data(), m_padded - m_size, m_padded, work, signal + pos, count);
+            std::copy(work + count, work + count + history, work);
+        }
+    }
+
+    /**
+     * \brief Sets the filter coefficients.
+     *
+     * Replaces the coefficients with new values. If the number of values
+     * differs from the current size, storage is reallocated and the delay
+     * line is cleared.
+     *
+     * \param factors Filter coefficients [h0, h1, ..., h(Size-1)].
+     *
+     * \throws std::invalid_argument if factors is empty.
+     */
+    void setFactors(const std::vector<T>& factors) {
+        if (factors.size() != m_size) {
+            configure(factors.size());
+        }
+        for (size_t i = 0; i < m_size; i++) {
+            tap(i) = factors[i];
+        }
+    }
+
+    /**
+     * \brief Gets a copy of the current coefficients.
+     *
+     * \return Coefficients in natural order [h0, h1, ..., h(Size-1)].
+     */
+    std::vector<T> getFactors() const {
+        std::vector<T> factors(m_size);
+        for (size_t i = 0; i < m_size; i++) {
+            factors[i] = tap(i);
+        }
+        return factors;
+    }
+
+    /// @brief Gets filter length
+    /// @return Number of coefficients
+    size_t size() const { return m_size; }
+
+    /**
+     * \brief Configures the filter as a low-pass filter.
+     *
+     * Designs coefficients with the windowed-sinc method used by
+     * FirFilter::setupLowPass, normalized to unity gain at DC.
+     *
+     * \param freq Normalized cutoff frequency in range (0.0, 0.5).
+     *
+     * \throws std::invalid_argument if freq <= 0.0 or freq >= 0.5.
+     */
+    void setupLowPass(T freq) {
+        if (freq <= 0 || freq >= 0.5) {
+            throw std::invalid_argument("Invalid frequency parameters! Use normalized frequency (0.0-0.5).");
+        }
+
+        T center = (static_cast<T>(m_size) - 1.0) / 2.0;
+        T sum = 0.0;
+
+        for (size_t i = 0; i < m_size; i++) {
+            T n = static_cast<T>(i);
+            T h = 0.0;
+            if (i == center) {
+                h = 2.0 * freq;
+            } else {
+                T x = 2.0 * M_PI * freq * (n - center);
+                h = FastMath<T>::sin(x) / (M_PI * (n - center));
+            }
+            tap(i) = h;
+            sum += h;
+        }
+
+        for (size_t i = 0; i < m_size; i++) {
+            tap(i) /= sum;
+        }
+    }
+
+    /**
+     * \brief Configures the filter as a high-pass filter.
+     *
+     * Designs coefficients by spectral inversion of a low-pass filter.
+     *
+     * \param freq Normalized cutoff frequency in range (0.0, 0.5).
+     *
+     * \throws std::invalid_argument if freq <= 0.0 or freq >= 0.5 (via setupLowPass).
+     */
+    void setupHighPass(T freq) {
+        setupLowPass(freq);
+
+        for (size_t i = 0; i < m_size; i++) {
+            tap(i) = -tap(i);
+        }
+
+        size_t center = (m_size - 1) / 2;
+        tap(center) += 1.0;
+    }
+
+    /**
+     * \brief Configures the filter as a band-pass filter.
+     *
+     * Designs coefficients by subtracting a low-pass filter from another
+     * low-pass filter with higher cutoff.
+     *
+     * \param freqLow Normalized lower cutoff frequency (0.0-0.5).
+     * \param freqHigh Normalized upper cutoff frequency (0.0-0.5).
+     *
+     * \throws std::invalid_argument if freqLow >= freqHigh.
+     * \throws std::invalid_argument if frequencies are out of valid range (via setupLowPass).
+     */
+    void setupBandPass(T freqLow, T freqHigh) {
+        if (freqLow >= freqHigh) {
+            throw std::invalid_argument("Low frequency must be smaller than High frequency!");
+        }
+
+        setupLowPass(freqHigh);
+
+        ScratchScope scratch;
+        T* highFactors = scratch.allocate<T>(m_size);
+        for (size_t i = 0; i < m_size; i++) {
+            highFactors[i] = tap(i);
+        }
+
+        setupLowPass(freqLow);
+
+        for (size_t i = 0; i < m_size; i++) {
+            tap(i) = highFactors[i] - tap(i);
+        }
+    }
+
+    /**
+     * \brief Resets the filter to its initial state.
+     *
+     * Clears the delay line. Filter coefficients are not affected.
+     */
+    void reset() override { m_work.fill(static_cast<T>(0.0)); }
+
+    /**
+     * \brief Sets the delay line to the steady state of a constant input.
+     *
+     * Fills the history with the level, so an input at that level produces
+     * level * sum(h) from the first sample on instead of a start-up transient.
+     *
+     * \param level Input level, e.g. the first sample of the signal.
+     */
+    void setSteadyState(T level) { std::fill(m_work.data(), m_work.data() + m_padded - 1, level); }
+
+    /// @brief Equality comparison operator
+    /// @param other Filter to compare with
+    /// @return true if filters have equal coefficients and history
+    bool operator==(const DynamicFirFilter<T>& other) const {
+        return m_coeffs == other.m_coeffs &&
+               std::equal(m_work.data(), m_work.data() + m_padded - 1, other.m_work.data());
+    }
+
+    /// @brief Inequality comparison operator
+    /// @param other Filter to compare with
+    /// @return true if filters are not equal
+    bool operator!=(const DynamicFirFilter<T>& other) const { return !(*this == other); }
+};
+}  // namespace md
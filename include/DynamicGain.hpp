@@ -0,0 +1,64 @@
+#pragma once
+#include <memory>
+
+#include "DynamicFilter.hpp"
+
+namespace md {
+/**
+ * \brief Scalar gain stage.
+ *
+ * Multiplies every sample by a constant. Used as a FilterChain stage for level
+ * adjustments; ChainOptimizer folds it into neighbouring coefficients.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class DynamicGain : public DynamicFilter<T> {
+   private:
+    /// \brief Gain factor
+    T m_gain;
+
+   public:
+    using DynamicFilter<T>::process;
+
+    /**
+     * \brief Creates a gain stage.
+     *
+     * \param gain Gain factor.
+     */
+    explicit DynamicGain(T gain = static_cast<T>(1.0)) : m_gain(gain) {}
+
+    /**
+     * \brief Processes a signal array in-place.
+     *
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    void process(T* signal, size_t length) override {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const T gain = m_gain;
+        for (size_t n = 0; n < length; n++) {
+            signal[n] *= gain;
+        }
+    }
+
+    /// @brief Does nothing, a gain has no state
+    void reset() override {}
+
+    /// @brief Creates a copy of the stage
+    /// @return New stage with the same gain
+    std::unique_ptr<DynamicFilter<T>> clone() const override { return std::make_unique<DynamicGain<T>>(*this); }
+
+    /// @brief Sets the gain factor
+    /// @param gain Gain factor
+    void setGain(T gain) { m_gain = gain; }
+
+    /// @brief Gets the gain factor
+    /// @return Gain factor
+    T getGain() const { return m_gain; }
+};
+}  // namespace md
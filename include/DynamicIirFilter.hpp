@@ -0,0 +1,230 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "DynamicFilter.hpp"
+
+namespace md {
+/**
+ * \brief Infinite Impulse Response (IIR) filter sized at runtime.
+ *
+ * Runtime counterpart of IirFilter with the same difference equation:
+ * y[n] = sum b[i] * x[n-i] - sum a[i] * y[n-1-i], where a0 = 1 is implied.
+ * The filter is evaluated in transposed direct form II, so each sample costs
+ * one pass over a single state vector of max(NumB-1, NumA) elements instead of
+ * shifting two history buffers. Coefficients and state are stored in aligned,
+ * zero-padded buffers allocated when the filter is configured.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class DynamicIirFilter : public DynamicFilter<T> {
+   private:
+    /// \brief Number of feedforward coefficients
+    size_t m_numB = 0;
+    /// \brief Number of feedback coefficients
+    size_t m_numA = 0;
+    /// \brief Filter order max(NumB-1, NumA)
+    size_t m_order = 0;
+    /// \brief Feedforward coefficients padded with zeros to m_order+1
+    AlignedBuffer<T> m_b;
+    /// \brief Feedback coefficients [a1, ..., aN] padded with zeros to m_order
+    AlignedBuffer<T> m_a;
+    /// \brief Transposed direct form II state, one extra zero element at m_order
+    AlignedBuffer<T> m_state;
+
+    /**
+     * \brief Allocates coefficient and state storage.
+     *
+     * \param numB Number of feedforward coefficients.
+     * \param numA Number of feedback coefficients.
+     *
+     * \throws std::invalid_argument if numB is 0.
+     */
+    void configure(size_t numB, size_t numA) {
+        if (numB == 0) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        m_numB = numB;
+        m_numA = numA;
+        m_order = std::max(numB - 1, numA);
+        m_b.resize(m_order + 1);
+        m_a.resize(m_order);
+        m_state.resize(m_order + 1);
+    }
+
+   public:
+    using DynamicFilter<T>::process;
+
+    /**
+     * \brief Creates a new IIR filter with cleared state.
+     *
+     * Allocates zeroed coefficients and state for the given sizes.
+     * Filter must be configured with setCoefficients() before use.
+     *
+     * \param numB Number of feedforward (numerator) coefficients.
+     * \param numA Number of feedback (denominator) coefficients.
+     *
+     * \throws std::invalid_argument if numB is 0.
+     */
+    DynamicIirFilter(size_t numB, size_t numA) { configure(numB, numA); }
+
+    /**
+     * \brief Creates a new IIR filter from existing coefficients.
+     *
+     * \param bFactors Feedforward coefficients [b0, b1, ..., b(NumB-1)].
+     * \param aFactors Feedback coefficients [a1, a2, ..., a(NumA)].
+     *
+     * \throws std::invalid_argument if bFactors is empty.
+     */
+    DynamicIirFilter(const std::vector<T>& bFactors, const std::vector<T>& aFactors) {
+        setCoefficients(bFactors, aFactors);
+    }
+
+    /**
+     * \brief Creates a copy of an existing IIR filter.
+     *
+     * Copies the coefficients and state from the source filter.
+     *
+     * \param other The source filter to copy from.
+     */
+    DynamicIirFilter(const DynamicIirFilter<T>& other) = default;
+
+    /// @brief Copy assignment operator
+    /// @param other Filter to copy from
+    /// @return Reference to this filter
+    DynamicIirFilter& operator=(const DynamicIirFilter<T>& other) = default;
+
+    /// @brief Creates a copy of the filter
+    /// @return New filter with the same coefficients and state
+    std::unique_ptr<DynamicFilter<T>> clone() const override { return std::make_unique<DynamicIirFilter<T>>(*this); }
+
+    /**
+     * \brief Processes a signal array in-place.
+     *
+     * Runs the transposed direct form II recursion over the block. The state
+     * update for one sample is a single loop over contiguous, padded arrays
+     * that the compiler vectorizes for higher filter orders.
+     *
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    void process(T* signal, size_t length) override {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const size_t order = m_order;
+        const T* b = m_b.data();
+        const T* a = m_a.data();
+        T* z = m_state.data();
+        const T b0 = b[0];
+        for (size_t n = 0; n < length; n++) {
+            const T x = signal[n];
+            const T y = b0 * x + z[0];
+            for (size_t i = 0; i < order; i++) {
+                z[i] = z[i + 1] + b[i + 1] * x - a[i] * y;
+            }
+            signal[n] = y;
+        }
+    }
+
+    /**
+     * \brief Sets the IIR filter coefficients.
+     *
+     * Configures the filter with feedforward (numerator) and feedback
+     * (denominator) coefficients. If the sizes differ from the current ones,
+     * storage is reallocated and the state is cleared.
+     *
+     * \param bFactors Feedforward coefficients [b0, b1, ..., b(NumB-1)].
+     * \param aFactors Feedback coefficients [a1, a2, ..., a(NumA)].
+     *
+     * \throws std::invalid_argument if bFactors is empty.
+     *
+     * \note The a0 coefficient is assumed to be 1 and is not included in aFactors.
+     * \note Ensure coefficients result in a stable filter (poles inside unit circle).
+     */
+    void setCoefficients(const std::vector<T>& bFactors, const std::vector<T>& aFactors) {
+        if (bFactors.size() != m_numB || aFactors.size() != m_numA) {
+            configure(bFactors.size(), aFactors.size());
+        }
+        std::copy(bFactors.begin(), bFactors.end(), m_b.data());
+        std::copy(aFactors.begin(), aFactors.end(), m_a.data());
+    }
+
+    /// @brief Gets feedforward coefficients
+    /// @return Copy of [b0, ..., b(NumB-1)]
+    std::vector<T> getBFactors() const { return std::vector<T>(m_b.data(), m_b.data() + m_numB); }
+
+    /// @brief Gets feedback coefficients
+    /// @return Copy of [a1, ..., a(NumA)]
+    std::vector<T> getAFactors() const { return std::vector<T>(m_a.data(), m_a.data() + m_numA); }
+
+    /// @brief Gets number of feedforward coefficients
+    /// @return NumB
+    size_t numB() const { return m_numB; }
+
+    /// @brief Gets number of feedback coefficients
+    /// @return NumA
+    size_t numA() const { return m_numA; }
+
+    /**
+     * \brief Resets the filter to its initial state.
+     *
+     * Clears the internal state. Unlike IirFilter::reset(), coefficients are
+     * kept, so the filter can be reused for a new signal without reconfiguring.
+     */
+    void reset() override { m_state.fill(static_cast<T>(0.0)); }
+
+    /**
+     * \brief Sets the state to the steady state of a constant input.
+     *
+     * With the settled output y = level * sum(b) / (1 + sum(a)), the
+     * transposed direct form II state is z[i] = sum over j > i of
+     * (b[j] * level - a[j] * y), so an input at that level continues without
+     * a start-up transient.
+     *
+     * \param level Input level, e.g. the first sample of the signal.
+     *
+     * \throws std::invalid_argument if the filter has a pole at z = 1 (1 + sum(a) = 0).
+     */
+    void setSteadyState(T level) {
+        const T* b = m_b.data();
+        const T* a = m_a.data();
+        T sumB = static_cast<T>(0.0);
+        T sumA = static_cast<T>(1.0);
+        for (size_t j = 0; j <= m_order; j++) {
+            sumB += b[j];
+        }
+        for (size_t j = 0; j < m_order; j++) {
+            sumA += a[j];
+        }
+        if (sumA == static_cast<T>(0.0)) {
+            throw std::invalid_argument("Filter has no steady state!");
+        }
+        const T y = level * sumB / sumA;
+        T* z = m_state.data();
+        T tail = static_cast<T>(0.0);
+        for (size_t i = m_order; i > 0; i--) {
+            tail += b[i] * level - a[i - 1] * y;
+            z[i - 1] = tail;
+        }
+        z[m_order] = static_cast<T>(0.0);
+    }
+
+    /// @brief Equality comparison operator
+    /// @param other Filter to compare with
+    /// @return true if filters are equal
+    bool operator==(const DynamicIirFilter<T>& other) const {
+        return m_numB == other.m_numB && m_numA == other.m_numA && m_b == other.m_b && m_a == other.m_a &&
+               m_state == other.m_state;
+    }
+
+    /// @brief Inequality comparison operator
+    /// @param other Filter to compare with
+    /// @return true if filters are not equal
+    bool operator!=(const DynamicIirFilter<T>& other) const { return !(*this == other); }
+};
+}  // namespace md
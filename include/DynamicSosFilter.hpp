@@ -0,0 +1,167 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "DynamicFilter.hpp"
+
+namespace md {
+/**
+ * \brief Coefficients of one second-order section.
+ *
+ * Transfer function (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+ * A first-order section has b2 = a2 = 0.
+ *
+ * \tparam T Data type.
+ */
+template <typename T>
+struct Biquad {
+    /// @brief Feedforward coefficient of x[n]
+    T b0 = 1;
+    /// @brief Feedforward coefficient of x[n-1]
+    T b1 = 0;
+    /// @brief Feedforward coefficient of x[n-2]
+    T b2 = 0;
+    /// @brief Feedback coefficient of y[n-1]
+    T a1 = 0;
+    /// @brief Feedback coefficient of y[n-2]
+    T a2 = 0;
+
+    /// @brief Equality comparison operator
+    /// @param other Section to compare with
+    /// @return true if all coefficients are equal
+    bool operator==(const Biquad<T>& other) const {
+        return b0 == other.b0 && b1 == other.b1 && b2 == other.b2 && a1 == other.a1 && a2 == other.a2;
+    }
+};
+
+/**
+ * \brief Cascade of second-order IIR sections sized at runtime.
+ *
+ * Evaluates all sections for one sample before moving to the next, each in
+ * transposed direct form II, with the coefficients of all sections stored
+ * next to each other and two state values per section. High-order IIR
+ * designs are far better conditioned as a cascade of biquads than as one
+ * direct-form polynomial, and keeping the whole cascade in one stage avoids
+ * passing the block through memory once per section.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class DynamicSosFilter : public DynamicFilter<T> {
+   private:
+    /// \brief Sections in processing order
+    std::vector<Biquad<T>> m_sections;
+    /// \brief State [z1, z2] of every section
+    AlignedBuffer<T> m_state;
+
+   public:
+    using DynamicFilter<T>::process;
+
+    /**
+     * \brief Creates a cascade from sections.
+     *
+     * \param sections Sections in processing order.
+     *
+     * \throws std::invalid_argument if sections is empty.
+     */
+    explicit DynamicSosFilter(const std::vector<Biquad<T>>& sections) { setSections(sections); }
+
+    /// @brief Creates a copy of the stage
+    /// @return New filter with the same sections and state
+    std::unique_ptr<DynamicFilter<T>> clone() const override { return std::make_unique<DynamicSosFilter<T>>(*this); }
+
+    /**
+     * \brief Processes a signal array in-place.
+     *
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    void process(T* signal, size_t length) override {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const Biquad<T>* sections = m_sections.data();
+        const size_t count = m_sections.size();
+        T* z = m_state.data();
+        for (size_t n = 0; n < length; n++) {
+            T x = signal[n];
+            for (size_t s = 0; s < count; s++) {
+                const Biquad<T>& q = sections[s];
+                const T y = q.b0 * x + z[2 * s];
+                z[2 * s] = q.b1 * x - q.a1 * y + z[2 * s + 1];
+                z[2 * s + 1] = q.b2 * x - q.a2 * y;
+                x = y;
+            }
+            signal[n] = x;
+        }
+    }
+
+    /**
+     * \brief Replaces the sections.
+     *
+     * The state is cleared.
+     *
+     * \param sections Sections in processing order.
+     *
+     * \throws std::invalid_argument if sections is empty.
+     */
+    void setSections(const std::vector<Biquad<T>>& sections) {
+        if (sections.empty()) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        m_sections = sections;
+        m_state.resize(2 * sections.size());
+    }
+
+    /// @brief Gets the sections
+    /// @return Sections in processing order
+    const std::vector<Biquad<T>>& getSections() const { return m_sections; }
+
+    /// @brief Gets number of sections
+    /// @return Section count
+    size_t numSections() const { return m_sections.size(); }
+
+    /// @brief Clears the state, coefficients are kept
+    void reset() override { m_state.fill(static_cast<T>(0.0)); }
+
+    /**
+     * \brief Sets the state to the steady state of a constant input.
+     *
+     * Every section is settled for the output level of the section before
+     * it, so an input at that level continues without a start-up transient.
+     *
+     * \param level Input level, e.g. the first sample of the signal.
+     *
+     * \throws std::invalid_argument if a section has a pole at z = 1 (1 + a1 + a2 = 0).
+     */
+    void setSteadyState(T level) {
+        T* z = m_state.data();
+        T x = level;
+        for (size_t s = 0; s < m_sections.size(); s++) {
+            const Biquad<T>& q = m_sections[s];
+            const T sumA = static_cast<T>(1.0) + q.a1 + q.a2;
+            if (sumA == static_cast<T>(0.0)) {
+                throw std::invalid_argument("Filter has no steady state!");
+            }
+            const T y = x * (q.b0 + q.b1 + q.b2) / sumA;
+            z[2 * s + 1] = q.b2 * x - q.a2 * y;
+            z[2 * s] = q.b1 * x - q.a1 * y + z[2 * s + 1];
+            x = y;
+        }
+    }
+
+    /// @brief Equality comparison operator
+    /// @param other Filter to compare with
+    /// @return true if filters are equal
+    bool operator==(const DynamicSosFilter<T>& other) const {
+        return m_sections == other.m_sections && m_state == other.m_state;
+    }
+
+    /// @brief Inequality comparison operator
+    /// @param other Filter to compare with
+    /// @return true if filters are not equal
+    bool operator!=(const DynamicSosFilter<T>& other) const { return !(*this == other); }
+};
+}  // namespace md
@@ -0,0 +1,299 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "FirFilter.hpp"
+
+namespace md {
+/**
+ * \brief Recursive least squares adaptive FIR filter with O(N) cost per sample.
+ *
+ * Minimizes sum lambda^(n-i) * (d[i] - w^T x[i])^2 like standard RLS, but
+ * with a stabilized fast transversal filter (FTF) instead of propagating the
+ * N x N inverse correlation matrix. The gain vector is updated from a
+ * forward and a backward linear predictor of the input, which costs about
+ * 8N multiply-adds per sample instead of O(N^2).
+ *
+ * The backward prediction error is available both directly and from the
+ * extended gain. In exact arithmetic the two are equal, and their difference
+ * is the error that makes plain FTF diverge. Feeding it back with the
+ * weights of Slock and Kailath (1.5 for the predictor, 2.5 for its energy)
+ * keeps the recursion stable for lambda close to 1, which this stabilization
+ * requires: 1 - lambda < 1 / (2 * numTaps), e.g. lambda > 0.984 for 32 taps.
+ *
+ * Outside this range restarts recur every few hundred samples and the
+ * weights do not converge (with lambda = 0.9 and 32 taps the error ends up
+ * larger than with zero weights), so the constructor rejects such settings;
+ * they need standard RLS.
+ *
+ * If the conversion factor or a prediction energy still leaves its valid
+ * range, the predictors are restarted from a cleared input history. The
+ * weights are kept, and restarts() counts these events, which are a rare
+ * rescue from round-off.
+ *
+ * Initialization corresponds to RLS with P(-1) = diag(1, lambda, ...,
+ * lambda^(N-1)) / delta, so in exact arithmetic the weights equal those of
+ * standard RLS started that way.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class FastRls {
+   private:
+    /// @brief Weight of the direct backward error in the backward predictor update
+    static constexpr T kKappaPredictor = static_cast<T>(1.5);
+    /// @brief Weight of the direct backward error in the backward energy update
+    static constexpr T kKappaEnergy = static_cast<T>(2.5);
+
+    /// \brief Number of taps
+    size_t m_numTaps = 0;
+    /// \brief Forgetting factor
+    T m_lambda;
+    /// \brief Initial regularization
+    T m_delta;
+    /// \brief Filter weights [w0, ..., w(N-1)]
+    AlignedBuffer<T> m_weights;
+    /// \brief Forward predictor of x[n] from x[n-1], ..., x[n-N]
+    AlignedBuffer<T> m_forward;
+    /// \brief Backward predictor of x[n-N] from x[n], ..., x[n-N+1]
+    AlignedBuffer<T> m_backward;
+    /// \brief A priori gain R^-1(n-1) x(n) / lambda
+    AlignedBuffer<T> m_gain;
+    /// \brief Order N+1 extension of the gain
+    AlignedBuffer<T> m_gainExt;
+    /// \brief Input history of N+1 samples, stored twice so every window is contiguous
+    AlignedBuffer<T> m_history;
+    /// \brief Start of the newest window in m_history
+    size_t m_head = 0;
+    /// \brief Inverse conversion factor 1 + x^T R^-1(n-1) x / lambda
+    T m_alpha;
+    /// \brief Forward prediction error energy
+    T m_forwardEnergy;
+    /// \brief Backward prediction error energy
+    T m_backwardEnergy;
+    /// \brief Number of predictor restarts
+    size_t m_restarts = 0;
+
+    /// @brief Clears the predictors, gain and input history, the weights are kept
+    void restartPredictors() {
+        m_history.fill(static_cast<T>(0.0));
+        m_forward.fill(static_cast<T>(0.0));
+        m_backward.fill(static_cast<T>(0.0));
+        m_gain.fill(static_cast<T>(0.0));
+        m_alpha = static_cast<T>(1.0);
+        m_forwardEnergy = m_delta;
+        m_backwardEnergy = m_delta * std::pow(m_lambda, -static_cast<T>(m_numTaps));
+    }
+
+   public:
+    /**
+     * \brief Creates an adaptive filter with zero weights.
+     *
+     * \param numTaps Number of taps (N).
+     * \param lambda Forgetting factor (1 - 1 / (2 * numTaps) < lambda <= 1).
+     * \param delta Initial regularization (> 0), small compared to the input power for fast convergence.
+     *
+     * \throws std::invalid_argument if numTaps is 0 or lambda or delta is out of range.
+     */
+    explicit FastRls(size_t numTaps, T lambda = static_cast<T>(0.999), T delta = static_cast<T>(0.01))
+        : m_numTaps(numTaps), m_lambda(lambda), m_delta(delta) {
+        if (numTaps == 0) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        if (!(lambda > 0 && lambda <= 1) || !(delta > 0)) {
+            throw std::invalid_argument("Invalid adaptation parameters!");
+        }
+        // The stabilized recursion diverges for smaller lambda (see the class description)
+        if (static_cast<T>(1.0) - lambda >= static_cast<T>(0.5) / static_cast<T>(numTaps)) {
+            throw std::invalid_argument("Forgetting factor too small for the number of taps!");
+        }
+        m_weights.resize(numTaps);
+        m_forward.resize(numTaps);
+        m_backward.resize(numTaps);
+        m_gain.resize(numTaps);
+        m_gainExt.resize(numTaps + 1);
+        m_history.resize(2 * (numTaps + 1));
+        restartPredictors();
+    }
+
+    /**
+     * \brief Adapts to one sample.
+     *
+     * \param input Input sample x[n].
+     * \param desired Desired output d[n].
+     *
+     * \return A priori error d[n] - w^T(n-1) x(n).
+     */
+    T update(T input, T desired) {
+        const size_t n = m_numTaps;
+        const T lambda = m_lambda;
+        m_head = m_head == 0 ? n : m_head - 1;
+        m_history[m_head] = input;
+        m_history[m_head + n + 1] = input;
+        // x[0] = x(n), x[0..N) is the regressor at n, x[1..N] the regressor at n-1
+        const T* x = m_history.data() + m_head;
+        T* a = m_forward.data();
+        T* b = m_backward.data();
+        T* g = m_gain.data();
+        T* gExt = m_gainExt.data();
+        T* w = m_weights.data();
+
+        // Forward prediction and order update of the gain
+        T ef = x[0];
+        for (size_t i = 0; i < n; i++) {
+            ef -= a[i] * x[i + 1];
+        }
+        const T scale = ef / (lambda * m_forwardEnergy);
+        gExt[0] = scale;
+        for (size_t i = 0; i < n; i++) {
+            gExt[i + 1] = g[i] - a[i] * scale;
+        }
+        const T alphaExt = m_alpha + ef * scale;
+        const T epsF = ef / m_alpha;
+        m_forwardEnergy = lambda * m_forwardEnergy + ef * epsF;
+        for (size_t i = 0; i < n; i++) {
+            a[i] += g[i] * epsF;
+        }
+
+        // Backward prediction and order downdate of the gain
+        const T last = gExt[n];
+        const T ebGain = lambda * m_backwardEnergy * last;
+        T eb = x[n];
+        for (size_t i = 0; i < n; i++) {
+            eb -= b[i] * x[i];
+        }
+        const T alpha = alphaExt - eb * last;
+        for (size_t i = 0; i < n; i++) {
+            g[i] = gExt[i] + b[i] * last;
+        }
+        const T ebPredictor = kKappaPredictor * eb + (static_cast<T>(1.0) - kKappaPredictor) * ebGain;
+        const T ebEnergy = kKappaEnergy * eb + (static_cast<T>(1.0) - kKappaEnergy) * ebGain;
+        const T stepB = ebPredictor / alpha;
+        for (size_t i = 0; i < n; i++) {
+            b[i] += g[i] * stepB;
+        }
+        m_backwardEnergy = lambda * m_backwardEnergy + ebEnergy * ebEnergy / alpha;
+        m_alpha = alpha;
+
+        // Joint process
+        T y = static_cast<T>(0.0);
+        for (size_t i = 0; i < n; i++) {
+            y += w[i] * x[i];
+        }
+        const T e = desired - y;
+
+        // alpha >= 1 and positive energies hold in exact arithmetic (also rejects NaN and overflow)
+        const T tolerance = std::sqrt(std::numeric_limits<T>::epsilon());
+        if (!(alpha >= static_cast<T>(1.0) - tolerance) || !(alpha < std::numeric_limits<T>::infinity()) ||
+            !(m_forwardEnergy > 0) || !(m_backwardEnergy > 0)) {
+            restartPredictors();
+            m_restarts++;
+            return e;
+        }
+        const T step = e / alpha;
+        for (size_t i = 0; i < n; i++) {
+            w[i] += g[i] * step;
+        }
+        return e;
+    }
+
+    /**
+     * \brief Adapts to a block of samples.
+     *
+     * \param input Input samples x.
+     * \param desired Desired output samples d.
+     * \param error Output for the a priori errors (may alias input or desired).
+     * \param length Number of samples.
+     *
+     * \throws std::invalid_argument if a pointer is nullptr or length is 0.
+     */
+    void process(const T* input, const T* desired, T* error, size_t length) {
+        if (input == nullptr || desired == nullptr || error == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t i = 0; i < length; i++) {
+            error[i] = update(input[i], desired[i]);
+        }
+    }
+
+    /**
+     * \brief Filters a block with the current weights, without adapting.
+     *
+     * Uses and advances the same input history as update(), so adaptation
+     * can continue afterwards.
+     *
+     * \param signal Pointer to the signal array to process in-place.
+     * \param length Number of samples.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    void filter(T* signal, size_t length) {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const size_t n = m_numTaps;
+        const T* w = m_weights.data();
+        for (size_t k = 0; k < length; k++) {
+            m_head = m_head == 0 ? n : m_head - 1;
+            m_history[m_head] = signal[k];
+            m_history[m_head + n + 1] = signal[k];
+            const T* x = m_history.data() + m_head;
+            T y = static_cast<T>(0.0);
+            for (size_t i = 0; i < n; i++) {
+                y += w[i] * x[i];
+            }
+            signal[k] = y;
+        }
+    }
+
+    /// @brief Gets the filter weights
+    /// @return Copy of [w0, ..., w(N-1)], usable with DynamicFirFilter::setFactors()
+    std::vector<T> getFactors() const { return std::vector<T>(m_weights.data(), m_weights.data() + m_numTaps); }
+
+    /**
+     * \brief Copies the weights into a FIR filter for deployment.
+     *
+     * \tparam Size Number of taps of the filter.
+     * \param filter Filter whose coefficients are replaced via setFactors().
+     *
+     * \throws std::invalid_argument if Size differs from numTaps().
+     */
+    template <size_t Size>
+    void exportTo(FirFilter<T, Size>& filter) const {
+        if (Size != m_numTaps) {
+            throw std::invalid_argument("Filter size mismatch!");
+        }
+        std::array<T, Size> factors;
+        std::copy(m_weights.data(), m_weights.data() + Size, factors.begin());
+        filter.setFactors(factors);
+    }
+
+    /**
+     * \brief Restarts adaptation.
+     *
+     * Clears the weights, predictors and input history.
+     */
+    void reset() {
+        m_weights.fill(static_cast<T>(0.0));
+        m_head = 0;
+        m_restarts = 0;
+        restartPredictors();
+    }
+
+    /// @brief Gets number of taps
+    /// @return N
+    size_t numTaps() const { return m_numTaps; }
+
+    /// @brief Gets forgetting factor
+    /// @return Lambda
+    T lambda() const { return m_lambda; }
+
+    /// @brief Gets number of predictor restarts since construction or reset()
+    /// @return Restart count
+    size_t restarts() const { return m_restarts; }
+};
+}  // namespace md
@@ -0,0 +1,242 @@
+#pragma once
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace md {
+/**
+ * \brief Radix-2 complex Fast Fourier Transform sized at runtime.
+ *
+ * Iterative decimation-in-time FFT with precomputed twiddle factors and
+ * bit-reversal permutation. All tables are computed once at construction,
+ * transforms run in-place and never allocate. The forward transform uses the
+ * exp(-2*pi*i*k*n/N) convention, the inverse transform is scaled by 1/N.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class Fft {
+   private:
+    /// \brief Transform length (power of two)
+    size_t m_size = 0;
+    /// \brief Twiddle factors exp(-2*pi*i*k/N) for k < N/2
+    std::vector<std::complex<T>> m_twiddles;
+    /// \brief Bit-reversed index of each position
+    std::vector<size_t> m_reversed;
+
+    /**
+     * \brief Runs the butterfly passes on bit-reversed data.
+     *
+     * \param data Data array of size() elements.
+     * \param inverse true to use conjugated twiddle factors.
+     */
+    void transform(std::complex<T>* data, bool inverse) const {
+        for (size_t i = 0; i < m_size; i++) {
+            size_t j = m_reversed[i];
+            if (i < j) {
+                std::swap(data[i], data[j]);
+            }
+        }
+        for (size_t half = 1; half < m_size; half *= 2) {
+            size_t stride = m_size / (2 * half);
+            for (size_t start = 0; start < m_size; start += 2 * half) {
+                for (size_t k = 0; k < half; k++) {
+                    std::complex<T> w = m_twiddles[k * stride];
+                    if (inverse) {
+                        w = std::conj(w);
+                    }
+                    std::complex<T> a = data[start + k];
+                    std::complex<T> b = data[start + k + half];
+                    T br = b.real() * w.real() - b.imag() * w.imag();
+                    T bi = b.real() * w.imag() + b.imag() * w.real();
+                    data[start + k] = std::complex<T>(a.real() + br, a.imag() + bi);
+                    data[start + k + half] = std::complex<T>(a.real() - br, a.imag() - bi);
+                }
+            }
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a transform of the given length.
+     *
+     * \param size Transform length (must be a power of two, >= 1).
+     *
+     * \throws std::invalid_argument if size is not a power of two.
+     */
+    explicit Fft(size_t size) : m_size(size) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+        if (size == 0 || (size & (size - 1)) != 0) {
+            throw std::invalid_argument("FFT size must be a power of two!");
+        }
+        m_twiddles.resize(size / 2);
+        for (size_t k = 0; k < size / 2; k++) {
+            T angle = static_cast<T>(-2.0 * M_PI) * static_cast<T>(k) / static_cast<T>(size);
+            m_twiddles[k] = std::complex<T>(std::cos(angle), std::sin(angle));
+        }
+        size_t bits = 0;
+        while ((static_cast<size_t>(1) << bits) < size) {
+            bits++;
+        }
+        m_reversed.resize(size);
+        for (size_t i = 0; i < size; i++) {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; b++) {
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            m_reversed[i] = r;
+        }
+    }
+
+    /**
+     * \brief Computes the forward transform in-place.
+     *
+     * \param data Data array of size() elements.
+     */
+    void forward(std::complex<T>* data) const { transform(data, false); }
+
+    /**
+     * \brief Computes the inverse transform in-place (scaled by 1/N).
+     *
+     * \param data Data array of size() elements.
+     */
+    void inverse(std::complex<T>* data) const {
+        transform(data, true);
+        T scale = static_cast<T>(1.0) / static_cast<T>(m_size);
+        for (size_t i = 0; i < m_size; i++) {
+            data[i] *= scale;
+        }
+    }
+
+    /// @brief Gets transform length
+    /// @return Number of points
+    size_t size() const { return m_size; }
+};
+
+/**
+ * \brief FFT of real signals computed with a half-length complex FFT.
+ *
+ * Packs even and odd samples into the real and imaginary parts of an N/2
+ * point complex transform and separates the spectra afterwards, which halves
+ * the work compared to a complex FFT of the zero-imaginary input. Produces
+ * the N/2+1 non-redundant bins.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class RealFft {
+   private:
+    /// \brief Half-length complex transform
+    Fft<T> m_half;
+    /// \brief Twiddle factors exp(-2*pi*i*k/N) for k <= N/2
+    std::vector<std::complex<T>> m_twiddles;
+    /// \brief Work buffer of N/2 complex values
+    std::vector<std::complex<T>> m_work;
+
+    /**
+     * \brief Packs a real signal into the work buffer and transforms it.
+     *
+     * \param input Real input of size() samples.
+     */
+    void transformHalf(const T* input) {
+        const size_t half = m_half.size();
+        for (size_t n = 0; n < half; n++) {
+            m_work[n] = std::complex<T>(input[2 * n], input[2 * n + 1]);
+        }
+        m_half.forward(m_work.data());
+    }
+
+    /**
+     * \brief Separates bin k of the real spectrum from the packed transform.
+     *
+     * \param k Bin index (0 <= k <= N/2).
+     *
+     * \return Spectrum value X[k].
+     */
+    std::complex<T> bin(size_t k) const {
+        const size_t half = m_half.size();
+        std::complex<T> z = m_work[k == half ? 0 : k];
+        std::complex<T> zc = std::conj(m_work[k == 0 ? 0 : half - k]);
+        std::complex<T> even = static_cast<T>(0.5) * (z + zc);
+        std::complex<T> odd = std::complex<T>(0, static_cast<T>(-0.5)) * (z - zc);
+        return even + m_twiddles[k] * odd;
+    }
+
+   public:
+    /**
+     * \brief Creates a real transform of the given length.
+     *
+     * \param size Transform length (power of two, >= 2).
+     *
+     * \throws std::invalid_argument if size is not a power of two or < 2.
+     */
+    explicit RealFft(size_t size) : m_half(size % 2 == 0 ? size / 2 : 0) {
+        // Fft rejects the half length unless it is a power of two, odd sizes are mapped to the invalid length 0
+        m_twiddles.resize(size / 2 + 1);
+        for (size_t k = 0; k <= size / 2; k++) {
+            T angle = static_cast<T>(-2.0 * M_PI) * static_cast<T>(k) / static_cast<T>(size);
+            m_twiddles[k] = std::complex<T>(std::cos(angle), std::sin(angle));
+        }
+        m_work.resize(size / 2);
+    }
+
+    /**
+     * \brief Computes the spectrum of a real signal.
+     *
+     * \param input Real input of size() samples.
+     * \param output Output of bins() complex values (bins 0..N/2).
+     */
+    void forward(const T* input, std::complex<T>* output) {
+        transformHalf(input);
+        for (size_t k = 0; k <= m_half.size(); k++) {
+            output[k] = bin(k);
+        }
+    }
+
+    /**
+     * \brief Computes the power spectrum |X[k]|^2 of a real signal.
+     *
+     * \param input Real input of size() samples.
+     * \param output Output of bins() power values.
+     */
+    void power(const T* input, T* output) {
+        transformHalf(input);
+        for (size_t k = 0; k <= m_half.size(); k++) {
+            std::complex<T> x = bin(k);
+            output[k] = x.real() * x.real() + x.imag() * x.imag();
+        }
+    }
+
+    /**
+     * \brief Reconstructs a real signal from its non-redundant spectrum.
+     *
+     * \param input Input of bins() complex values (bins 0..N/2).
+     * \param output Real output of size() samples (scaled by 1/N).
+     */
+    void inverse(const std::complex<T>* input, T* output) {
+        const size_t half = m_half.size();
+        for (size_t k = 0; k < half; k++) {
+            std::complex<T> x = input[k];
+            std::complex<T> xc = std::conj(input[half - k]);
+            std::complex<T> even = static_cast<T>(0.5) * (x + xc);
+            std::complex<T> odd = static_cast<T>(0.5) * (x - xc) * std::conj(m_twiddles[k]);
+            m_work[k] = even + std::complex<T>(0, 1) * odd;
+        }
+        m_half.inverse(m_work.data());
+        for (size_t n = 0; n < half; n++) {
+            output[2 * n] = m_work[n].real();
+            output[2 * n + 1] = m_work[n].imag();
+        }
+    }
+
+    /// @brief Gets transform length
+    /// @return Number of real samples
+    size_t size() const { return 2 * m_half.size(); }
+
+    /// @brief Gets number of spectrum bins
+    /// @return N/2+1
+    size_t bins() const { return m_half.size() + 1; }
+};
+}  // namespace md
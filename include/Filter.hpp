@@ -1,4 +1,8 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "SignalProcessor.hpp"
 
 namespace md {
@@ -10,11 +14,53 @@ namespace md {
  * according to stored coefficients and internal state. The class maintains
  * filter state across multiple process() calls, enabling continuous filtering.
  *
+ * Optionally, block processing can be gated for channels that are silent
+ * most of the time: blocks whose samples are all within a threshold are not
+ * filtered once the filter state has decayed, and produce zeros instead.
+ *
  * \tparam T Data type (must be floating-point).
  * \tparam Size Filter order (number of coefficients).
  */
 template <typename T, size_t Size>
 class Filter : public SignalProcessor<T, Size> {
+   private:
+    /// @brief Number of samples checked and skipped together when gating
+    static constexpr size_t kGateBlock = 64;
+    /// @brief Number of independent maxima in the quiet check (one SIMD register of floats)
+    static constexpr size_t kGateLanes = 8;
+
+    /// \brief Gating enabled flag
+    bool m_gateEnabled = false;
+    /// \brief Largest input magnitude treated as silence
+    T m_gateThreshold = static_cast<T>(0.0);
+    /// \brief Largest state magnitude treated as decayed
+    T m_gateEpsilon = static_cast<T>(0.0);
+
+    /**
+     * \brief Checks if all samples of a block are within the gate threshold.
+     *
+     * Keeps kGateLanes independent flags so the loop vectorizes. A NaN
+     * sample fails the comparison, so blocks with NaN are never gated.
+     *
+     * \param signal Block start.
+     * \param count Number of samples.
+     *
+     * \return true if |x| <= threshold for every sample.
+     */
+    bool isQuiet(const T* signal, size_t count) const {
+        bool loud[kGateLanes] = {};
+        size_t i = 0;
+        for (; i + kGateLanes <= count; i += kGateLanes) {
+            for (size_t l = 0; l < kGateLanes; l++) {
+                loud[l] |= !(std::abs(signal[i + l]) <= m_gateThreshold);
+            }
+        }
+        for (; i < count; i++) {
+            loud[0] |= !(std::abs(signal[i]) <= m_gateThreshold);
+        }
+        return std::none_of(loud, loud + kGateLanes, [](bool flag) { return flag; });
+    }
+
    public:
     /**
      * \brief Resets the filter to its initial state.
@@ -53,6 +99,9 @@ class Filter : public SignalProcessor<T, Size> {
      * modifying the signal in-place. The filter maintains its internal
      * state across calls, enabling continuous processing of signal.
      *
+     * With gating enabled, the signal is handled in blocks of kGateBlock
+     * samples and quiet blocks are replaced by zeros while the filter is idle.
+     *
      * \param signal Pointer to the signal array to process.
      * \param length Number of samples in the signal array.
      *
@@ -62,15 +111,98 @@ class Filter : public SignalProcessor<T, Size> {
         if (signal == nullptr || length == 0) {
             throw std::invalid_argument("Bad array!");
         }
-        for (size_t i = 0; i < length; i++) {
-            signal[i] = processSample(signal[i]);
+        if (!m_gateEnabled) {
+            for (size_t i = 0; i < length; i++) {
+                signal[i] = processSample(signal[i]);
+            }
+            return;
+        }
+        for (size_t pos = 0; pos < length; pos += kGateBlock) {
+            size_t count = std::min(kGateBlock, length - pos);
+            T* block = signal + pos;
+            if (isQuiet(block, count) && isIdle(m_gateEpsilon)) {
+                clearState();
+                std::fill(block, block + count, static_cast<T>(0.0));
+                continue;
+            }
+            for (size_t i = 0; i < count; i++) {
+                block[i] = processSample(block[i]);
+            }
         }
     }
 
+    /**
+     * \brief Enables gating of silent blocks in process(T*, size_t).
+     *
+     * A block is skipped when every input sample satisfies |x| <= threshold
+     * and the filter state (delay lines) satisfies |s| <= epsilon; the state
+     * is then cleared and the block is set to zero. A FIR filter therefore
+     * resumes skipping Size samples after the input became quiet, an IIR
+     * filter once its response has decayed below epsilon. With threshold and
+     * epsilon equal to 0 the output is exact; otherwise the error of a skipped
+     * sample is bounded by the response of the filter to inputs and states of
+     * that magnitude. Container processing is not gated.
+     *
+     * \param threshold Largest input magnitude treated as silence (>= 0).
+     * \param epsilon Largest state magnitude treated as decayed (>= 0).
+     *
+     * \throws std::invalid_argument if threshold or epsilon is negative.
+     */
+    void setGate(T threshold, T epsilon) {
+        if (threshold < 0 || epsilon < 0) {
+            throw std::invalid_argument("Gate threshold and epsilon must not be negative!");
+        }
+        m_gateThreshold = threshold;
+        m_gateEpsilon = epsilon;
+        m_gateEnabled = true;
+    }
+
+    /// @brief Disables gating, every sample is filtered again
+    void disableGate() { m_gateEnabled = false; }
+
+    /// @brief Checks if gating is enabled
+    /// @return true if quiet blocks may be skipped
+    bool isGateEnabled() const { return m_gateEnabled; }
+
+    /// @brief Gets gate threshold
+    /// @return Largest input magnitude treated as silence
+    T getGateThreshold() const { return m_gateThreshold; }
+
+    /// @brief Gets gate epsilon
+    /// @return Largest state magnitude treated as decayed
+    T getGateEpsilon() const { return m_gateEpsilon; }
+
+    /**
+     * \brief Gets the current state values.
+     *
+     * Lists everything the next outputs depend on besides the coefficients,
+     * in a fixed order, so equal states give equal lists (used by ResultKey).
+     * The default returns an empty list.
+     *
+     * \return State values.
+     */
+    virtual std::vector<T> getStateValues() const { return {}; }
+
    protected:
     /// @brief Default constructor
     Filter() = default;
 
+    /**
+     * \brief Checks if two filters gate the same way.
+     *
+     * Thresholds of disabled gates are ignored, as they have no effect.
+     *
+     * \param other Filter to compare with.
+     *
+     * \return true if both gates are disabled or have equal settings.
+     */
+    bool isSameGate(const Filter<T, Size>& other) const {
+        if (m_gateEnabled != other.m_gateEnabled) {
+            return false;
+        }
+        return !m_gateEnabled || (m_gateThreshold == other.m_gateThreshold && m_gateEpsilon == other.m_gateEpsilon);
+    }
+
    private:
     /**
      * \brief Processes a single sample through the filter.
@@ -84,5 +216,28 @@ class Filter : public SignalProcessor<T, Size> {
      * \return Filtered output sample.
      */
     virtual T processSample(T input) = 0;
+
+    /**
+     * \brief Checks if the filter state has decayed.
+     *
+     * Used by gating. The default never reports idle, so filters that do not
+     * override it are never skipped.
+     *
+     * \param epsilon Largest state magnitude treated as zero.
+     *
+     * \return true if every state value satisfies |s| <= epsilon.
+     */
+    virtual bool isIdle(T epsilon) const {
+        (void)epsilon;
+        return false;
+    }
+
+    /**
+     * \brief Clears the filter state without touching coefficients.
+     *
+     * Called by gating before a block is skipped, so that processing resumes
+     * from an exactly zero state.
+     */
+    virtual void clearState() {}
 };
 }  // namespace md
\ No newline at end of file
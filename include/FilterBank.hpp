@@ -0,0 +1,359 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+
+namespace md {
+/**
+ * \brief Spectral filter bank (mel, bark, constant-Q) applied to power spectra.
+ *
+ * Maps power spectra with fftSize/2+1 bins (e.g. from Stft::processPower) to
+ * band energies. Each band only covers a short run of neighbouring bins, so
+ * the band-weight matrix is stored sparsely: per band, the first bin, the
+ * number of bins and an offset into one contiguous weight array. Compared to
+ * a dense bands x bins product this skips all the zero weights.
+ *
+ * apply() handles many frames per call. Frames are processed in tiles of
+ * kFrameTile: a tile is transposed into a bin-major scratch buffer, so each
+ * weight is applied to kFrameTile frames with one vectorized multiply-add.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class FilterBank {
+   private:
+    /// @brief Number of frames evaluated together
+    static constexpr size_t kFrameTile = 8;
+
+    /// \brief Number of spectrum bins per frame
+    size_t m_numBins = 0;
+    /// \brief First bin of each band
+    std::vector<size_t> m_start;
+    /// \brief Number of bins of each band
+    std::vector<size_t> m_count;
+    /// \brief Offset of each band in m_weights
+    std::vector<size_t> m_offset;
+    /// \brief Non-zero weights of all bands, band after band
+    AlignedBuffer<T> m_weights;
+    /// \brief Bin-major tile of kFrameTile frames
+    AlignedBuffer<T> m_tile;
+
+    /**
+     * \brief Stores dense band weights in sparse form.
+     *
+     * \param dense Weights, one vector of numBins values per band.
+     */
+    void compress(const std::vector<std::vector<T>>& dense) {
+        size_t bands = dense.size();
+        m_start.assign(bands, 0);
+        m_count.assign(bands, 0);
+        m_offset.assign(bands, 0);
+        size_t total = 0;
+        for (size_t b = 0; b < bands; b++) {
+            size_t first = m_numBins;
+            size_t last = 0;
+            for (size_t k = 0; k < m_numBins; k++) {
+                if (dense[b][k] != static_cast<T>(0.0)) {
+                    first = std::min(first, k);
+                    last = k;
+                }
+            }
+            if (first <= last) {
+                m_start[b] = first;
+                m_count[b] = last - first + 1;
+            }
+            m_offset[b] = total;
+            total += m_count[b];
+        }
+        m_weights.resize(total);
+        for (size_t b = 0; b < bands; b++) {
+            std::copy(dense[b].begin() + m_start[b], dense[b].begin() + m_start[b] + m_count[b],
+                      m_weights.data() + m_offset[b]);
+        }
+        m_tile.resize(m_numBins * kFrameTile);
+    }
+
+    /**
+     * \brief Validates the common spectrum parameters.
+     *
+     * \param numBands Number of bands.
+     * \param fftSize FFT length.
+     * \param sampleRate Sampling frequency in Hz.
+     * \param fMin Lowest band edge in Hz.
+     * \param fMax Highest band edge in Hz.
+     *
+     * \throws std::invalid_argument if any parameter is out of range.
+     */
+    void configure(size_t numBands, size_t fftSize, T sampleRate, T fMin, T fMax) {
+        if (numBands == 0 || fftSize < 2 || sampleRate <= 0) {
+            throw std::invalid_argument("Invalid filter bank parameters!");
+        }
+        if (fMin < 0 || fMin >= fMax || fMax > sampleRate / 2) {
+            throw std::invalid_argument("Invalid frequency parameters! Use 0 <= fMin < fMax <= sampleRate/2.");
+        }
+        m_numBins = fftSize / 2 + 1;
+    }
+
+    /// @brief Converts Hz to mel (HTK formula)
+    /// @param f Frequency in Hz
+    /// @return Frequency in mel
+    static T hzToMel(T f) {
+        return static_cast<T>(2595.0) * std::log10(static_cast<T>(1.0) + f / static_cast<T>(700.0));
+    }
+    /// @brief Converts mel to Hz (HTK formula)
+    /// @param m Frequency in mel
+    /// @return Frequency in Hz
+    static T melToHz(T m) {
+        return static_cast<T>(700.0) * (std::pow(static_cast<T>(10.0), m / static_cast<T>(2595.0)) - 1);
+    }
+    /// @brief Converts Hz to Bark (Traunmueller formula)
+    /// @param f Frequency in Hz
+    /// @return Frequency in Bark
+    static T hzToBark(T f) {
+        return static_cast<T>(26.81) * f / (static_cast<T>(1960.0) + f) - static_cast<T>(0.53);
+    }
+    /// @brief Converts Bark to Hz (Traunmueller formula)
+    /// @param z Frequency in Bark
+    /// @return Frequency in Hz
+    static T barkToHz(T z) {
+        return static_cast<T>(1960.0) * (z + static_cast<T>(0.53)) / (static_cast<T>(26.28) - z);
+    }
+
+   public:
+    /**
+     * \brief Creates an empty filter bank.
+     *
+     * Filter bank must be configured with a setup method before use.
+     */
+    FilterBank() { static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!"); }
+
+    /**
+     * \brief Configures triangular bands from a list of edge frequencies.
+     *
+     * Band b rises linearly from edges[b] to a peak of 1 at edges[b+1] and
+     * falls back to zero at edges[b+2]. A band narrower than the bin spacing
+     * gets weight 1 on the bin nearest to its centre.
+     *
+     * \param edges Increasing edge frequencies in Hz (numBands + 2 values).
+     * \param fftSize FFT length used to compute the spectra.
+     * \param sampleRate Sampling frequency in Hz.
+     *
+     * \throws std::invalid_argument if fewer than 3 edges are given or they are out of range.
+     */
+    void setupTriangular(const std::vector<T>& edges, size_t fftSize, T sampleRate) {
+        if (edges.size() < 3) {
+            throw std::invalid_argument("At least 3 band edges are required!");
+        }
+        size_t bands = edges.size() - 2;
+        configure(bands, fftSize, sampleRate, edges.front(), edges.back());
+        T binWidth = sampleRate / static_cast<T>(fftSize);
+        std::vector<std::vector<T>> dense(bands, std::vector<T>(m_numBins, static_cast<T>(0.0)));
+        for (size_t b = 0; b < bands; b++) {
+            T left = edges[b];
+            T center = edges[b + 1];
+            T right = edges[b + 2];
+            if (!(left < center && center < right)) {
+                throw std::invalid_argument("Band edges must be strictly increasing!");
+            }
+            bool any = false;
+            for (size_t k = 0; k < m_numBins; k++) {
+                T f = static_cast<T>(k) * binWidth;
+                T w = 0;
+                if (f > left && f <= center) {
+                    w = (f - left) / (center - left);
+                } else if (f > center && f < right) {
+                    w = (right - f) / (right - center);
+                }
+                dense[b][k] = w;
+                any = any || w > 0;
+            }
+            if (!any) {
+                size_t nearest = std::min(m_numBins - 1, static_cast<size_t>(std::lround(center / binWidth)));
+                dense[b][nearest] = static_cast<T>(1.0);
+            }
+        }
+        compress(dense);
+    }
+
+    /**
+     * \brief Configures a mel filter bank.
+     *
+     * Triangular bands with edges equally spaced on the HTK mel scale.
+     *
+     * \param numBands Number of mel bands.
+     * \param fftSize FFT length used to compute the spectra.
+     * \param sampleRate Sampling frequency in Hz.
+     * \param fMin Lower edge of the first band in Hz.
+     * \param fMax Upper edge of the last band in Hz.
+     *
+     * \throws std::invalid_argument if any parameter is out of range.
+     */
+    void setupMel(size_t numBands, size_t fftSize, T sampleRate, T fMin, T fMax) {
+        configure(numBands, fftSize, sampleRate, fMin, fMax);
+        T low = hzToMel(fMin);
+        T high = hzToMel(fMax);
+        std::vector<T> edges(numBands + 2);
+        for (size_t i = 0; i < edges.size(); i++) {
+            edges[i] = melToHz(low + (high - low) * static_cast<T>(i) / static_cast<T>(numBands + 1));
+        }
+        edges.front() = fMin;
+        edges.back() = fMax;
+        setupTriangular(edges, fftSize, sampleRate);
+    }
+
+    /**
+     * \brief Configures a bark filter bank.
+     *
+     * Triangular bands with edges equally spaced on the Bark scale.
+     *
+     * \param numBands Number of bark bands.
+     * \param fftSize FFT length used to compute the spectra.
+     * \param sampleRate Sampling frequency in Hz.
+     * \param fMin Lower edge of the first band in Hz.
+     * \param fMax Upper edge of the last band in Hz.
+     *
+     * \throws std::invalid_argument if any parameter is out of range.
+     */
+    void setupBark(size_t numBands, size_t fftSize, T sampleRate, T fMin, T fMax) {
+        configure(numBands, fftSize, sampleRate, fMin, fMax);
+        T low = hzToBark(fMin);
+        T high = hzToBark(fMax);
+        std::vector<T> edges(numBands + 2);
+        for (size_t i = 0; i < edges.size(); i++) {
+            edges[i] = barkToHz(low + (high - low) * static_cast<T>(i) / static_cast<T>(numBands + 1));
+        }
+        edges.front() = fMin;
+        edges.back() = fMax;
+        setupTriangular(edges, fftSize, sampleRate);
+    }
+
+    /**
+     * \brief Configures a constant-Q filter bank.
+     *
+     * Band k is centred at fMin * 2^(k / binsPerOctave) and has bandwidth
+     * centre / Q with Q = 1 / (2^(1/binsPerOctave) - 1). Weights follow a Hann
+     * shape over the band and are normalized to unit sum, so every band
+     * reports the average power of the bins it covers. Bands narrower than
+     * the bin spacing use the nearest bin.
+     *
+     * \param binsPerOctave Number of bands per octave.
+     * \param fftSize FFT length used to compute the spectra.
+     * \param sampleRate Sampling frequency in Hz.
+     * \param fMin Centre frequency of the first band in Hz (> 0).
+     * \param fMax Highest allowed centre frequency in Hz.
+     *
+     * \throws std::invalid_argument if any parameter is out of range.
+     */
+    void setupConstantQ(size_t binsPerOctave, size_t fftSize, T sampleRate, T fMin, T fMax) {
+        configure(binsPerOctave, fftSize, sampleRate, fMin, fMax);
+        if (fMin <= 0) {
+            throw std::invalid_argument("Constant-Q requires fMin > 0!");
+        }
+        T ratio = std::pow(static_cast<T>(2.0), static_cast<T>(1.0) / static_cast<T>(binsPerOctave));
+        T q = static_cast<T>(1.0) / (ratio - 1);
+        size_t bands = static_cast<size_t>(std::floor(std::log2(fMax / fMin) * static_cast<T>(binsPerOctave))) + 1;
+        T binWidth = sampleRate / static_cast<T>(fftSize);
+        std::vector<std::vector<T>> dense(bands, std::vector<T>(m_numBins, static_cast<T>(0.0)));
+        for (size_t b = 0; b < bands; b++) {
+            T center = fMin * std::pow(ratio, static_cast<T>(b));
+            T halfWidth = center / q / 2;
+            T sum = 0;
+            for (size_t k = 0; k < m_numBins; k++) {
+                T offset = static_cast<T>(k) * binWidth - center;
+                if (std::abs(offset) < halfWidth) {
+                    T w = static_cast<T>(0.5) * (1 + std::cos(static_cast<T>(M_PI) * offset / halfWidth));
+                    dense[b][k] = w;
+                    sum += w;
+                }
+            }
+            if (sum == 0) {
+                size_t nearest = std::min(m_numBins - 1, static_cast<size_t>(std::lround(center / binWidth)));
+                dense[b][nearest] = static_cast<T>(1.0);
+                sum = static_cast<T>(1.0);
+            }
+            for (size_t k = 0; k < m_numBins; k++) {
+                dense[b][k] /= sum;
+            }
+        }
+        compress(dense);
+    }
+
+    /**
+     * \brief Applies the filter bank to a batch of power spectra.
+     *
+     * \param spectra Input, numFrames x bins() power values (row per frame).
+     * \param numFrames Number of frames.
+     * \param bands Output, numFrames x numBands() values (row per frame).
+     *
+     * \throws std::invalid_argument if the bank is not configured or a pointer is nullptr.
+     */
+    void apply(const T* spectra, size_t numFrames, T* bands) {
+        if (m_numBins == 0) {
+            throw std::invalid_argument("Filter bank is not configured!");
+        }
+        if (spectra == nullptr || bands == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const size_t numBands = m_start.size();
+        T* tile = m_tile.data();
+        for (size_t f0 = 0; f0 < numFrames; f0 += kFrameTile) {
+            size_t frames = std::min(kFrameTile, numFrames - f0);
+            for (size_t f = 0; f < frames; f++) {
+                const T* row = spectra + (f0 + f) * m_numBins;
+                for (size_t k = 0; k < m_numBins; k++) {
+                    tile[k * kFrameTile + f] = row[k];
+                }
+            }
+            for (size_t b = 0; b < numBands; b++) {
+                T acc[kFrameTile] = {};
+                const T* w = m_weights.data() + m_offset[b];
+                const T* column = tile + m_start[b] * kFrameTile;
+                for (size_t k = 0; k < m_count[b]; k++) {
+                    const T weight = w[k];
+                    for (size_t f = 0; f < kFrameTile; f++) {
+                        acc[f] += weight * column[k * kFrameTile + f];
+                    }
+                }
+                for (size_t f = 0; f < frames; f++) {
+                    bands[(f0 + f) * numBands + b] = acc[f];
+                }
+            }
+        }
+    }
+
+    /// @brief Gets number of bands
+    /// @return Number of output values per frame
+    size_t numBands() const { return m_start.size(); }
+
+    /// @brief Gets number of spectrum bins
+    /// @return Number of input values per frame
+    size_t bins() const { return m_numBins; }
+
+    /// @brief Gets number of stored (non-zero) weights
+    /// @return Number of multiply-adds per frame
+    size_t nonZeros() const { return m_weights.size(); }
+
+    /**
+     * \brief Gets the dense weights of one band.
+     *
+     * \param band Band index.
+     *
+     * \return bins() weights of the band.
+     *
+     * \throws std::out_of_range if band >= numBands().
+     */
+    std::vector<T> bandWeights(size_t band) const {
+        if (band >= m_start.size()) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        std::vector<T> dense(m_numBins, static_cast<T>(0.0));
+        std::copy(m_weights.data() + m_offset[band], m_weights.data() + m_offset[band] + m_count[band],
+                  dense.begin() + m_start[band]);
+        return dense;
+    }
+};
+}  // namespace md
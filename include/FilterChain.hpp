@@ -0,0 +1,193 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "DynamicFilter.hpp"
+
+namespace md {
+/**
+ * \brief Cascade of runtime-sized filters applied in order.
+ *
+ * Owns its stages and is itself a DynamicFilter, so chains can be nested,
+ * cloned per worker thread and used wherever a single filter is expected.
+ * The signal is passed through all stages in blocks of kBlock samples, which
+ * keeps the block in L1 cache while every stage works on it instead of
+ * streaming the whole signal through memory once per stage.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class FilterChain : public DynamicFilter<T> {
+   private:
+    /// @brief Number of samples passed through all stages at a time
+    static constexpr size_t kBlock = 1024;
+
+    /// \brief Stages in processing order
+    std::vector<std::unique_ptr<DynamicFilter<T>>> m_stages;
+
+   public:
+    using DynamicFilter<T>::process;
+
+    /// @brief Creates an empty chain (passes signals unchanged)
+    FilterChain() = default;
+
+    /**
+     * \brief Creates a deep copy of a chain.
+     *
+     * \param other The source chain to copy from.
+     */
+    FilterChain(const FilterChain<T>& other) : DynamicFilter<T>() {
+        m_stages.reserve(other.m_stages.size());
+        for (const std::unique_ptr<DynamicFilter<T>>& stage : other.m_stages) {
+            m_stages.push_back(stage->clone());
+        }
+    }
+
+    /// @brief Copy assignment operator (deep copy)
+    /// @param other Chain to copy from
+    /// @return Reference to this chain
+    FilterChain& operator=(const FilterChain<T>& other) {
+        if (this != &other) {
+            FilterChain<T> copy(other);
+            m_stages = std::move(copy.m_stages);
+        }
+        return *this;
+    }
+
+    /// @brief Move constructor
+    FilterChain(FilterChain<T>&&) = default;
+
+    /// @brief Move assignment operator
+    /// @return Reference to this chain
+    FilterChain& operator=(FilterChain<T>&&) = default;
+
+    /**
+     * \brief Appends a stage.
+     *
+     * \param stage Filter to append (ownership is taken).
+     *
+     * \throws std::invalid_argument if stage is nullptr.
+     */
+    void add(std::unique_ptr<DynamicFilter<T>> stage) {
+        if (!stage) {
+            throw std::invalid_argument("Stage must not be null!");
+        }
+        m_stages.push_back(std::move(stage));
+    }
+
+    /**
+     * \brief Appends a copy of a filter.
+     *
+     * \param stage Filter to copy into the chain.
+     */
+    void add(const DynamicFilter<T>& stage) { m_stages.push_back(stage.clone()); }
+
+    /**
+     * \brief Constructs a stage in place.
+     *
+     * \tparam Stage Filter type.
+     * \param args Constructor arguments of Stage.
+     *
+     * \return Reference to the new stage, e.g. to run a setup method on it.
+     */
+    template <typename Stage, typename... Args>
+    Stage& emplace(Args&&... args) {
+        auto stage = std::make_unique<Stage>(std::forward<Args>(args)...);
+        Stage& reference = *stage;
+        m_stages.push_back(std::move(stage));
+        return reference;
+    }
+
+    /**
+     * \brief Removes a stage.
+     *
+     * \param index Stage index.
+     *
+     * \return The removed stage.
+     *
+     * \throws std::out_of_range if index >= size().
+     */
+    std::unique_ptr<DynamicFilter<T>> remove(size_t index) {
+        if (index >= m_stages.size()) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        std::unique_ptr<DynamicFilter<T>> stage = std::move(m_stages[index]);
+        m_stages.erase(m_stages.begin() + static_cast<std::ptrdiff_t>(index));
+        return stage;
+    }
+
+    /**
+     * \brief Processes a signal array in-place through all stages.
+     *
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    void process(T* signal, size_t length) override {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t pos = 0; pos < length; pos += kBlock) {
+            size_t count = std::min(kBlock, length - pos);
+            for (std::unique_ptr<DynamicFilter<T>>& stage : m_stages) {
+                stage->process(signal + pos, count);
+            }
+        }
+    }
+
+    /// @brief Resets the state of every stage, coefficients are kept
+    void reset() override {
+        for (std::unique_ptr<DynamicFilter<T>>& stage : m_stages) {
+            stage->reset();
+        }
+    }
+
+    /// @brief Creates a deep copy of the chain
+    /// @return New chain with copies of all stages
+    std::unique_ptr<DynamicFilter<T>> clone() const override { return std::make_unique<FilterChain<T>>(*this); }
+
+    /// @brief Gets number of stages
+    /// @return Stage count
+    size_t size() const { return m_stages.size(); }
+
+    /// @brief Checks if the chain has no stages
+    /// @return true if signals pass unchanged
+    bool empty() const { return m_stages.empty(); }
+
+    /**
+     * \brief Gets a stage.
+     *
+     * \param index Stage index.
+     *
+     * \return Reference to the stage.
+     *
+     * \throws std::out_of_range if index >= size().
+     */
+    DynamicFilter<T>& stage(size_t index) {
+        if (index >= m_stages.size()) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        return *m_stages[index];
+    }
+
+    /**
+     * \brief Gets a stage.
+     *
+     * \param index Stage index.
+     *
+     * \return Reference to the stage.
+     *
+     * \throws std::out_of_range if index >= size().
+     */
+    const DynamicFilter<T>& stage(size_t index) const {
+        if (index >= m_stages.size()) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        return *m_stages[index];
+    }
+};
+}  // namespace md
@@ -0,0 +1,779 @@
+#pragma once
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "FilterChain.hpp"
+#include "PageAllocator.hpp"
+#include "ThreadPool.hpp"
+
+namespace md {
+/**
+ * \brief Counters reported by a FilterService.
+ */
+struct ServiceStats {
+    /// @brief Number of processed requests
+    uint64_t requests = 0;
+    /// @brief Number of batches the requests were processed in
+    uint64_t batches = 0;
+    /// @brief Number of processed samples
+    uint64_t samples = 0;
+    /// @brief Number of rejected requests
+    uint64_t errors = 0;
+    /// @brief Mean time between receipt and start of processing in seconds
+    double meanQueueLatency = 0.0;
+    /// @brief Largest time between receipt and start of processing in seconds
+    double maxQueueLatency = 0.0;
+    /// @brief Processed samples per second of processing time
+    double throughput = 0.0;
+    /// @brief Time since the service started in seconds
+    double uptime = 0.0;
+};
+
+namespace detail {
+/// @brief Identifies messages of the service protocol
+constexpr uint32_t kServiceMagic = 0x4d445356;
+/// @brief Maximum length of a chain name including the terminating zero
+constexpr size_t kChainNameLength = 64;
+
+/// \brief Request types of the service protocol
+enum class ServiceRequestType : uint32_t { Process = 1, Stats = 2 };
+
+/// \brief Status codes of the service protocol
+enum class ServiceStatus : int32_t { Ok = 0, UnknownChain = 1, BadRequest = 2, Failed = 3 };
+
+/// \brief Request message; a Process request carries the payload descriptor (SCM_RIGHTS)
+struct ServiceRequest {
+    /// @brief Protocol identifier
+    uint32_t magic;
+    /// @brief Request type
+    ServiceRequestType type;
+    /// @brief Client-chosen request identifier, echoed in the response
+    uint64_t id;
+    /// @brief sizeof(T) of the payload samples
+    uint64_t sampleSize;
+    /// @brief Number of payload samples
+    uint64_t length;
+    /// @brief Zero-terminated chain name
+    char chain[kChainNameLength];
+};
+
+/// \brief Response message
+struct ServiceResponse {
+    /// @brief Identifier of the request
+    uint64_t id;
+    /// @brief Result of the request
+    ServiceStatus status;
+    /// @brief Time the request waited before processing in seconds
+    double queueLatency;
+    /// @brief Processing time in seconds
+    double processTime;
+    /// @brief Service counters (Stats requests)
+    ServiceStats stats;
+};
+
+/// @brief Clock used for latency measurements
+using ServiceClock = std::chrono::steady_clock;
+
+/**
+ * \brief Gets the seconds between two time points.
+ *
+ * \param from Start time.
+ * \param to End time.
+ *
+ * \return Elapsed seconds.
+ */
+inline double secondsBetween(ServiceClock::time_point from, ServiceClock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+/**
+ * \brief Fills a Unix socket address.
+ *
+ * \param path Socket path.
+ *
+ * \return Socket address.
+ *
+ * \throws std::invalid_argument if the path is too long.
+ */
+inline sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Invalid socket path!");
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+}  // namespace detail
+
+/**
+ * \brief Sample buffer in shared memory, passed to a FilterService by descriptor.
+ *
+ * The buffer is a memfd mapped into the client. The service maps the same
+ * pages and filters them in place, so request payloads are never copied
+ * through the socket. The memfd is sealed against shrinking and growing, so
+ * its size cannot change while the service works on it; the service rejects
+ * payloads without the shrink seal.
+ *
+ * \tparam T Sample type.
+ */
+template <typename T>
+class SharedBuffer {
+   private:
+    /// \brief Descriptor of the memfd
+    int m_fd = -1;
+    /// \brief Mapped samples
+    T* m_data = nullptr;
+    /// \brief Number of samples
+    size_t m_capacity = 0;
+
+   public:
+    /**
+     * \brief Creates a buffer.
+     *
+     * The page mode, prefault and lock settings of the policy apply to the
+     * client's mapping regardless of the size threshold. Explicit huge pages
+     * are not available for memfd payloads and are treated as transparent.
+     *
+     * \param capacity Number of samples.
+     * \param policy Allocation policy of the mapping.
+     *
+     * \throws std::invalid_argument if capacity is 0 or too large.
+     * \throws std::runtime_error if the shared memory cannot be created.
+     */
+    explicit SharedBuffer(size_t capacity, const MemoryPolicy& policy = MemoryPolicy()) : m_capacity(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        if (capacity > SIZE_MAX / sizeof(T) ||
+            capacity * sizeof(T) > static_cast<size_t>(std::numeric_limits<off_t>::max())) {
+            throw std::invalid_argument("Size is too large!");
+        }
+        m_fd = ::memfd_create("md-shared-buffer", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (m_fd < 0 || ::ftruncate(m_fd, static_cast<off_t>(capacity * sizeof(T))) != 0 ||
+            ::fcntl(m_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0) {
+            if (m_fd >= 0) {
+                ::close(m_fd);
+            }
+            throw std::runtime_error("Failed to create shared buffer");
+        }
+        size_t bytes = capacity * sizeof(T);
+        bool transparent = policy.pages != PageMode::Default;
+        // Huge pages must be advised before the pages are populated
+        int flags = MAP_SHARED | (policy.prefault && !transparent ? MAP_POPULATE : 0);
+        void* data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, m_fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(m_fd);
+            throw std::runtime_error("Failed to map shared buffer");
+        }
+        if (transparent) {
+            ::madvise(data, bytes, MADV_HUGEPAGE);
+            if (policy.prefault) {
+                detail::touchPages(data, bytes);
+            }
+        }
+        if (policy.lock) {
+            ::mlock(data, bytes);
+        }
+        m_data = static_cast<T*>(data);
+    }
+
+    SharedBuffer(const SharedBuffer&) = delete;
+    SharedBuffer& operator=(const SharedBuffer&) = delete;
+
+    /// @brief Unmaps and closes the buffer
+    ~SharedBuffer() {
+        ::munmap(m_data, m_capacity * sizeof(T));
+        ::close(m_fd);
+    }
+
+    /// @brief Gets the samples
+    /// @return Pointer to capacity() samples
+    T* data() { return m_data; }
+
+    /// @brief Gets number of samples
+    /// @return Capacity
+    size_t capacity() const { return m_capacity; }
+
+    /// @brief Gets the memfd descriptor
+    /// @return File descriptor
+    int fd() const { return m_fd; }
+};
+
+/**
+ * \brief Long-running local filtering service.
+ *
+ * Keeps designed filter chains loaded and filters request payloads for
+ * clients that connect over a Unix domain socket (SOCK_SEQPACKET), so short
+ * tools do not pay start-up and filter design on every run. A request names
+ * a chain and passes a SharedBuffer descriptor; the payload is filtered in
+ * place from a cleared state and a response is sent when it is done.
+ *
+ * Requests are queued per chain. A worker of the internal ThreadPool takes
+ * all requests queued for a chain at once (up to kMaxBatch) and processes
+ * them back to back with one chain instance, so concurrent small requests
+ * share one scheduling step and a warm cache. Each worker uses its own clone
+ * of a chain, so the same chain runs on several workers when its queue is
+ * long. The service counts requests, batches, samples, queue latency
+ * (receipt to start of processing) and throughput, see stats().
+ *
+ * \tparam T Sample type (must be floating-point).
+ */
+template <typename T>
+class FilterService {
+   private:
+    /// @brief Maximum number of requests processed as one batch
+    static constexpr size_t kMaxBatch = 64;
+
+    /// \brief Client connection (closed when the last request referring to it completes)
+    struct Connection {
+        /// @brief Socket descriptor
+        int fd;
+        /// @brief Takes ownership of a socket
+        explicit Connection(int socket) : fd(socket) {}
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+        /// @brief Closes the socket
+        ~Connection() { ::close(fd); }
+    };
+
+    /// \brief Queued request
+    struct Request {
+        /// @brief Connection to respond on
+        std::shared_ptr<Connection> connection;
+        /// @brief Client request identifier
+        uint64_t id;
+        /// @brief Mapped payload
+        T* data;
+        /// @brief Number of payload samples
+        size_t length;
+        /// @brief Time of receipt
+        detail::ServiceClock::time_point received;
+    };
+
+    /// \brief Loaded chain with its queue
+    struct Chain {
+        /// @brief Chain as registered
+        FilterChain<T> prototype;
+        /// @brief Protects all members below
+        std::mutex mutex;
+        /// @brief Chain instances not in use by a worker
+        std::vector<std::unique_ptr<FilterChain<T>>> idle;
+        /// @brief Requests waiting for a worker
+        std::deque<Request> pending;
+        /// @brief Number of workers processing this chain
+        size_t active = 0;
+    };
+
+    /// \brief Socket path
+    std::string m_path;
+    /// \brief Loaded chains by name
+    std::map<std::string, std::unique_ptr<Chain>> m_chains;
+    /// \brief Listening socket
+    int m_listen = -1;
+    /// \brief Event descriptor waking the I/O thread on stop()
+    int m_wake = -1;
+    /// \brief Thread accepting connections and receiving requests
+    std::thread m_io;
+    /// \brief Set while the service runs
+    std::atomic<bool> m_running{false};
+    /// \brief Protects the statistics
+    std::mutex m_statsMutex;
+    /// \brief Statistics counters (latencies hold sums until reported)
+    ServiceStats m_stats;
+    /// \brief Total processing time in seconds
+    double m_processTime = 0.0;
+    /// \brief Start time
+    detail::ServiceClock::time_point m_started;
+    /// \brief Stop time
+    detail::ServiceClock::time_point m_stopped;
+    /// \brief Workers (declared last: destroyed first, finishing all batches)
+    std::unique_ptr<ThreadPool> m_pool;
+
+    /**
+     * \brief Sends a response.
+     *
+     * \param connection Client connection.
+     * \param response Response message.
+     */
+    static void respond(const Connection& connection, const detail::ServiceResponse& response) {
+        ::send(connection.fd, &response, sizeof(response), MSG_NOSIGNAL);
+    }
+
+    /**
+     * \brief Rejects a request.
+     *
+     * \param connection Client connection.
+     * \param id Request identifier.
+     * \param status Error status.
+     */
+    void reject(const Connection& connection, uint64_t id, detail::ServiceStatus status) {
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_stats.errors++;
+        }
+        detail::ServiceResponse response{};
+        response.id = id;
+        response.status = status;
+        respond(connection, response);
+    }
+
+    /**
+     * \brief Starts a worker for a chain if requests wait and workers are free.
+     *
+     * \param chain Chain to schedule (mutex must be held).
+     */
+    void schedule(Chain& chain) {
+        if (!chain.pending.empty() && chain.active < m_pool->size()) {
+            chain.active++;
+            m_pool->submit([this, &chain] { runBatches(chain); });
+        }
+    }
+
+    /**
+     * \brief Processes batches of a chain until its queue is empty.
+     *
+     * \param chain Chain to process.
+     */
+    void runBatches(Chain& chain) {
+        std::vector<Request> batch;
+        std::unique_ptr<FilterChain<T>> instance;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(chain.mutex);
+                if (chain.pending.empty()) {
+                    if (instance) {
+                        chain.idle.push_back(std::move(instance));
+                    }
+                    chain.active--;
+                    return;
+                }
+                size_t count = std::min(kMaxBatch, chain.pending.size());
+                batch.assign(std::make_move_iterator(chain.pending.begin()),
+                             std::make_move_iterator(chain.pending.begin() + static_cast<std::ptrdiff_t>(count)));
+                chain.pending.erase(chain.pending.begin(), chain.pending.begin() + static_cast<std::ptrdiff_t>(count));
+                if (!instance) {
+                    if (chain.idle.empty()) {
+                        instance = std::make_unique<FilterChain<T>>(chain.prototype);
+                    } else {
+                        instance = std::move(chain.idle.back());
+                        chain.idle.pop_back();
+                    }
+                }
+                schedule(chain);
+            }
+
+            double queueLatency = 0.0;
+            double maxLatency = 0.0;
+            uint64_t samples = 0;
+            detail::ServiceClock::time_point batchStart = detail::ServiceClock::now();
+            for (Request& request : batch) {
+                detail::ServiceClock::time_point start = detail::ServiceClock::now();
+                detail::ServiceResponse response{};
+                response.id = request.id;
+                response.queueLatency = detail::secondsBetween(request.received, start);
+                try {
+                    instance->reset();
+                    instance->process(request.data, request.length);
+                    response.status = detail::ServiceStatus::Ok;
+                } catch (const std::exception&) {
+                    response.status = detail::ServiceStatus::Failed;
+                }
+                response.processTime = detail::secondsBetween(start, detail::ServiceClock::now());
+                ::munmap(request.data, request.length * sizeof(T));
+                respond(*request.connection, response);
+                queueLatency += response.queueLatency;
+                maxLatency = std::max(maxLatency, response.queueLatency);
+                samples += request.length;
+            }
+            double processTime = detail::secondsBetween(batchStart, detail::ServiceClock::now());
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                m_stats.requests += batch.size();
+                m_stats.batches++;
+                m_stats.samples += samples;
+                m_stats.meanQueueLatency += queueLatency;
+                m_stats.maxQueueLatency = std::max(m_stats.maxQueueLatency, maxLatency);
+                m_processTime += processTime;
+            }
+            batch.clear();
+        }
+    }
+
+    /**
+     * \brief Receives one request from a client.
+     *
+     * \param connection Client connection.
+     *
+     * \return false if the client disconnected.
+     */
+    bool receive(const std::shared_ptr<Connection>& connection) {
+        detail::ServiceRequest request{};
+        iovec io{&request, sizeof(request)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        msghdr message{};
+        message.msg_iov = &io;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        ssize_t received = ::recvmsg(connection->fd, &message, MSG_CMSG_CLOEXEC);
+        if (received <= 0) {
+            return false;
+        }
+        int payload = -1;
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+                std::memcpy(&payload, CMSG_DATA(header), sizeof(int));
+            }
+        }
+        auto closePayload = [&payload] {
+            if (payload >= 0) {
+                ::close(payload);
+            }
+        };
+
+        if (received != static_cast<ssize_t>(sizeof(request)) || request.magic != detail::kServiceMagic) {
+            closePayload();
+            reject(*connection, request.id, detail::ServiceStatus::BadRequest);
+            return true;
+        }
+        if (request.type == detail::ServiceRequestType::Stats) {
+            closePayload();
+            detail::ServiceResponse response{};
+            response.id = request.id;
+            response.status = detail::ServiceStatus::Ok;
+            response.stats = stats();
+            respond(*connection, response);
+            return true;
+        }
+        request.chain[detail::kChainNameLength - 1] = '\0';
+        auto found = m_chains.find(request.chain);
+        if (found == m_chains.end()) {
+            closePayload();
+            reject(*connection, request.id, detail::ServiceStatus::UnknownChain);
+            return true;
+        }
+        // The payload must be sealed against shrinking, or the client could truncate it while it is processed
+        struct stat info;
+        int seals = payload >= 0 ? ::fcntl(payload, F_GET_SEALS) : -1;
+        if (request.type != detail::ServiceRequestType::Process || payload < 0 || request.sampleSize != sizeof(T) ||
+            request.length == 0 || ::fstat(payload, &info) != 0 || info.st_size < 0 ||
+            request.length > static_cast<uint64_t>(info.st_size) / sizeof(T) || seals < 0 ||
+            (seals & F_SEAL_SHRINK) == 0) {
+            closePayload();
+            reject(*connection, request.id, detail::ServiceStatus::BadRequest);
+            return true;
+        }
+        size_t bytes = static_cast<size_t>(request.length) * sizeof(T);
+        void* data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, payload, 0);
+        closePayload();
+        if (data == MAP_FAILED) {
+            reject(*connection, request.id, detail::ServiceStatus::BadRequest);
+            return true;
+        }
+
+        Chain& chain = *found->second;
+        std::lock_guard<std::mutex> lock(chain.mutex);
+        chain.pending.push_back(Request{connection, request.id, static_cast<T*>(data),
+                                        static_cast<size_t>(request.length), detail::ServiceClock::now()});
+        schedule(chain);
+        return true;
+    }
+
+    /// @brief I/O loop: accepts clients and receives requests until stop()
+    void serve() {
+        std::vector<std::shared_ptr<Connection>> connections;
+        std::vector<pollfd> descriptors;
+        while (m_running.load()) {
+            descriptors.assign({pollfd{m_listen, POLLIN, 0}, pollfd{m_wake, POLLIN, 0}});
+            for (const std::shared_ptr<Connection>& connection : connections) {
+                descriptors.push_back(pollfd{connection->fd, POLLIN, 0});
+            }
+            if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                continue;
+            }
+            std::vector<std::shared_ptr<Connection>> open;
+            open.reserve(connections.size() + 1);
+            for (size_t i = 0; i < connections.size(); i++) {
+                short events = descriptors[i + 2].revents;
+                if ((events & POLLIN) != 0 && receive(connections[i])) {
+                    open.push_back(connections[i]);
+                } else if ((events & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) == 0) {
+                    open.push_back(connections[i]);
+                }
+            }
+            if ((descriptors[0].revents & POLLIN) != 0) {
+                int client = ::accept4(m_listen, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client >= 0) {
+                    open.push_back(std::make_shared<Connection>(client));
+                }
+            }
+            connections = std::move(open);
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a service (not yet listening).
+     *
+     * \param socketPath Path of the Unix socket to listen on.
+     * \param numThreads Number of worker threads (0 = hardware concurrency).
+     */
+    explicit FilterService(std::string socketPath, size_t numThreads = 0)
+        : m_path(std::move(socketPath)), m_pool(std::make_unique<ThreadPool>(numThreads)) {}
+
+    FilterService(const FilterService&) = delete;
+    FilterService& operator=(const FilterService&) = delete;
+
+    /// @brief Stops the service and finishes queued requests
+    ~FilterService() {
+        stop();
+        m_pool.reset();
+    }
+
+    /**
+     * \brief Loads a chain under a name.
+     *
+     * One clone per worker is created right away, so the first requests do
+     * not pay for copying coefficients. Chains must be added before start().
+     *
+     * \param name Chain name used in requests (shorter than 64 characters).
+     * \param chain Designed chain (copied).
+     *
+     * \throws std::invalid_argument if the name is empty, too long or already used.
+     * \throws std::logic_error if the service is running.
+     */
+    void addChain(const std::string& name, const FilterChain<T>& chain) {
+        if (m_running.load()) {
+            throw std::logic_error("Chains must be added before the service starts!");
+        }
+        if (name.empty() || name.size() >= detail::kChainNameLength || m_chains.count(name) != 0) {
+            throw std::invalid_argument("Invalid or duplicate chain name!");
+        }
+        auto entry = std::make_unique<Chain>();
+        entry->prototype = chain;
+        for (size_t i = 0; i < m_pool->size(); i++) {
+            entry->idle.push_back(std::make_unique<FilterChain<T>>(chain));
+        }
+        m_chains.emplace(name, std::move(entry));
+    }
+
+    /**
+     * \brief Starts listening and serving requests in a background thread.
+     *
+     * An existing socket file at the path is replaced.
+     *
+     * \throws std::runtime_error if the socket cannot be created.
+     */
+    void start() {
+        if (m_running.load()) {
+            return;
+        }
+        sockaddr_un address = detail::socketAddress(m_path);
+        ::unlink(m_path.c_str());
+        m_listen = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        m_wake = ::eventfd(0, EFD_CLOEXEC);
+        if (m_listen < 0 || m_wake < 0 ||
+            ::bind(m_listen, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(m_listen, SOMAXCONN) != 0) {
+            if (m_listen >= 0) {
+                ::close(m_listen);
+            }
+            if (m_wake >= 0) {
+                ::close(m_wake);
+            }
+            m_listen = m_wake = -1;
+            throw std::runtime_error("Failed to create service socket");
+        }
+        m_started = detail::ServiceClock::now();
+        m_running.store(true);
+        m_io = std::thread([this] { serve(); });
+    }
+
+    /// @brief Stops accepting requests; queued requests still complete
+    void stop() {
+        if (!m_running.exchange(false)) {
+            return;
+        }
+        uint64_t one = 1;
+        if (::write(m_wake, &one, sizeof(one)) < 0) {
+            // The I/O thread also wakes up on the next client event
+        }
+        m_io.join();
+        m_stopped = detail::ServiceClock::now();
+        ::close(m_listen);
+        ::close(m_wake);
+        ::unlink(m_path.c_str());
+        m_listen = m_wake = -1;
+    }
+
+    /**
+     * \brief Gets the service counters.
+     *
+     * \return Snapshot of the statistics.
+     */
+    ServiceStats stats() {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ServiceStats result = m_stats;
+        result.meanQueueLatency = m_stats.requests > 0 ? m_stats.meanQueueLatency / m_stats.requests : 0.0;
+        result.throughput = m_processTime > 0.0 ? static_cast<double>(m_stats.samples) / m_processTime : 0.0;
+        result.uptime = detail::secondsBetween(m_started, m_running.load() ? detail::ServiceClock::now() : m_stopped);
+        return result;
+    }
+
+    /// @brief Checks if the service is running
+    /// @return true between start() and stop()
+    bool isRunning() const { return m_running.load(); }
+
+    /// @brief Gets the socket path
+    /// @return Path clients connect to
+    const std::string& path() const { return m_path; }
+};
+
+/**
+ * \brief Client of a FilterService.
+ *
+ * Sends one request at a time over its connection; use one client per
+ * thread for concurrent requests.
+ *
+ * \tparam T Sample type (must match the service).
+ */
+template <typename T>
+class FilterClient {
+   private:
+    /// \brief Connected socket
+    int m_fd = -1;
+    /// \brief Identifier of the next request
+    uint64_t m_nextId = 1;
+
+    /**
+     * \brief Sends a request and waits for its response.
+     *
+     * \param request Request message.
+     * \param payload Payload descriptor (-1 for none).
+     *
+     * \return Response message.
+     *
+     * \throws std::runtime_error if the service cannot be reached.
+     */
+    detail::ServiceResponse transact(detail::ServiceRequest& request, int payload) {
+        request.magic = detail::kServiceMagic;
+        request.id = m_nextId++;
+        iovec io{&request, sizeof(request)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        msghdr message{};
+        message.msg_iov = &io;
+        message.msg_iovlen = 1;
+        if (payload >= 0) {
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            cmsghdr* header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(header), &payload, sizeof(int));
+        }
+        if (::sendmsg(m_fd, &message, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(request))) {
+            throw std::runtime_error("Failed to send request");
+        }
+        detail::ServiceResponse response{};
+        do {
+            if (::recv(m_fd, &response, sizeof(response), 0) != static_cast<ssize_t>(sizeof(response))) {
+                throw std::runtime_error("Failed to receive response");
+            }
+        } while (response.id != request.id);
+        return response;
+    }
+
+   public:
+    /**
+     * \brief Connects to a service.
+     *
+     * \param socketPath Socket path of the service.
+     *
+     * \throws std::runtime_error if the service cannot be reached.
+     */
+    explicit FilterClient(const std::string& socketPath) {
+        sockaddr_un address = detail::socketAddress(socketPath);
+        m_fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (m_fd < 0 || ::connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (m_fd >= 0) {
+                ::close(m_fd);
+            }
+            throw std::runtime_error("Failed to connect to service");
+        }
+    }
+
+    FilterClient(const FilterClient&) = delete;
+    FilterClient& operator=(const FilterClient&) = delete;
+
+    /// @brief Disconnects
+    ~FilterClient() { ::close(m_fd); }
+
+    /**
+     * \brief Filters the first samples of a shared buffer in place.
+     *
+     * \param chain Name of a chain loaded in the service.
+     * \param buffer Shared buffer holding the signal.
+     * \param length Number of samples to filter (<= buffer.capacity()).
+     *
+     * \return Time the request waited in the service queue in seconds.
+     *
+     * \throws std::invalid_argument if the chain name or length is invalid.
+     * \throws std::runtime_error if the service rejects or fails the request.
+     */
+    double process(const std::string& chain, SharedBuffer<T>& buffer, size_t length) {
+        if (chain.empty() || chain.size() >= detail::kChainNameLength || length == 0 || length > buffer.capacity()) {
+            throw std::invalid_argument("Bad array!");
+        }
+        detail::ServiceRequest request{};
+        request.type = detail::ServiceRequestType::Process;
+        request.sampleSize = sizeof(T);
+        request.length = length;
+        std::memcpy(request.chain, chain.c_str(), chain.size() + 1);
+        detail::ServiceResponse response = transact(request, buffer.fd());
+        if (response.status == detail::ServiceStatus::UnknownChain) {
+            throw std::invalid_argument("Unknown chain!");
+        }
+        if (response.status != detail::ServiceStatus::Ok) {
+            throw std::runtime_error("Service failed to process request");
+        }
+        return response.queueLatency;
+    }
+
+    /**
+     * \brief Gets the service counters.
+     *
+     * \return Statistics of the service.
+     *
+     * \throws std::runtime_error if the service cannot be reached.
+     */
+    ServiceStats stats() {
+        detail::ServiceRequest request{};
+        request.type = detail::ServiceRequestType::Stats;
+        return transact(request, -1).stats;
+    }
+};
+}  // namespace md
@@ -0,0 +1,255 @@
+#pragma once
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "FirFilter.hpp"
+
+namespace md {
+namespace detail {
+/**
+ * \brief Describes how far back a filter depends on its input.
+ *
+ * Filters with infinite memory (IIR) need their state at the start of a range
+ * to resume; the default assumes this.
+ */
+template <typename FilterType>
+struct FilterMemory {
+    /// @brief true if output depends only on a bounded input history
+    static constexpr bool finite = false;
+    /// @brief Number of preceding input samples the output depends on
+    static constexpr size_t history = 0;
+};
+
+/// \brief FIR filters depend only on the Size-1 preceding input samples
+template <typename T, size_t Size>
+struct FilterMemory<FirFilter<T, Size>> {
+    /// @brief true if output depends only on a bounded input history
+    static constexpr bool finite = true;
+    /// @brief Number of preceding input samples the output depends on
+    static constexpr size_t history = Size - 1;
+};
+}  // namespace detail
+
+/**
+ * \brief Lazily filtered view of a long recording.
+ *
+ * Produces the output of a filter applied to a whole signal from its first
+ * sample, but only for the ranges that are requested, so reading a short
+ * range late in a long recording does not require filtering everything
+ * before it on every access. Output is computed in fixed-size chunks which
+ * are kept in a least-recently-used cache.
+ *
+ * A FirFilter chunk is computed independently by priming the delay line with
+ * the Size-1 input samples preceding the chunk. Other filters (IirFilter)
+ * resume from a checkpoint of their state (getState()/setState()) stored at
+ * the start of every chunk; checkpoints are created the first time the
+ * filter runs past a chunk boundary, so the first access far into the signal
+ * runs the filter up to there once and later accesses resume directly.
+ *
+ * The source samples are not copied and must outlive the view (e.g. a
+ * memory-mapped file).
+ *
+ * \tparam T Data type (must be floating-point).
+ * \tparam FilterType Filter with State, getState() and setState(), e.g.
+ *         FirFilter<T, Size> or IirFilter<T, NumB, NumA>.
+ */
+template <typename T, typename FilterType>
+class FilteredSignalView {
+   private:
+    /// \brief Cached output chunk
+    struct Entry {
+        /// @brief Filtered samples of the chunk
+        std::vector<T> data;
+        /// @brief Position in the recency list
+        typename std::list<size_t>::iterator position;
+    };
+
+    /// \brief Source samples
+    const T* m_source = nullptr;
+    /// \brief Number of source samples
+    size_t m_length = 0;
+    /// \brief Number of samples per chunk
+    size_t m_chunkSize = 0;
+    /// \brief Maximum number of cached chunks
+    size_t m_capacity = 0;
+    /// \brief Filter used to compute chunks (coefficients of the prototype)
+    FilterType m_filter;
+    /// \brief Filter state at the start of chunk c, for c < size() (infinite memory only)
+    std::vector<typename FilterType::State> m_checkpoints;
+    /// \brief Cached chunks by index
+    std::unordered_map<size_t, Entry> m_cache;
+    /// \brief Chunk indices, most recently used first
+    std::list<size_t> m_recency;
+    /// \brief Scratch for chunks computed only to advance checkpoints
+    std::vector<T> m_scratch;
+    /// \brief Number of chunks served from the cache
+    size_t m_hits = 0;
+    /// \brief Number of chunks computed
+    size_t m_misses = 0;
+
+    /**
+     * \brief Filters one chunk.
+     *
+     * \param chunk Chunk index.
+     * \param output Output of the chunk's length.
+     */
+    void compute(size_t chunk, std::vector<T>& output) {
+        size_t begin = chunk * m_chunkSize;
+        size_t count = std::min(m_chunkSize, m_length - begin);
+        if constexpr (detail::FilterMemory<FilterType>::finite) {
+            m_filter.setState(typename FilterType::State{});
+            size_t primeStart = begin > detail::FilterMemory<FilterType>::history
+                                    ? begin - detail::FilterMemory<FilterType>::history
+                                    : 0;
+            if (primeStart < begin) {
+                m_scratch.assign(m_source + primeStart, m_source + begin);
+                m_filter.process(m_scratch.data(), m_scratch.size());
+            }
+            output.assign(m_source + begin, m_source + begin + count);
+            m_filter.process(output.data(), count);
+        } else {
+            while (m_checkpoints.size() <= chunk) {
+                size_t last = m_checkpoints.size() - 1;
+                size_t lastBegin = last * m_chunkSize;
+                m_scratch.assign(m_source + lastBegin, m_source + std::min(m_length, lastBegin + m_chunkSize));
+                m_filter.setState(m_checkpoints[last]);
+                m_filter.process(m_scratch.data(), m_scratch.size());
+                m_checkpoints.push_back(m_filter.getState());
+            }
+            m_filter.setState(m_checkpoints[chunk]);
+            output.assign(m_source + begin, m_source + begin + count);
+            m_filter.process(output.data(), count);
+            if (m_checkpoints.size() == chunk + 1 && begin + count < m_length) {
+                m_checkpoints.push_back(m_filter.getState());
+            }
+        }
+    }
+
+    /**
+     * \brief Gets a chunk from the cache, computing it if needed.
+     *
+     * \param chunk Chunk index.
+     *
+     * \return Filtered samples of the chunk.
+     */
+    const std::vector<T>& fetch(size_t chunk) {
+        auto found = m_cache.find(chunk);
+        if (found != m_cache.end()) {
+            m_recency.splice(m_recency.begin(), m_recency, found->second.position);
+            m_hits++;
+            return found->second.data;
+        }
+        m_misses++;
+        std::vector<T> data;
+        if (m_cache.size() >= m_capacity) {
+            auto evicted = m_cache.find(m_recency.back());
+            data = std::move(evicted->second.data);
+            m_cache.erase(evicted);
+            m_recency.pop_back();
+        }
+        compute(chunk, data);
+        m_recency.push_front(chunk);
+        Entry& entry = m_cache[chunk];
+        entry.data = std::move(data);
+        entry.position = m_recency.begin();
+        return entry.data;
+    }
+
+   public:
+    /**
+     * \brief Creates a view of a signal filtered by a copy of a filter.
+     *
+     * Only the coefficients of the filter are used; filtering starts from a
+     * cleared state at sample 0.
+     *
+     * \param filter Configured filter.
+     * \param source Source samples (not copied).
+     * \param length Number of source samples.
+     * \param chunkSize Number of samples computed and cached together.
+     * \param cacheChunks Maximum number of cached chunks.
+     *
+     * \throws std::invalid_argument if source is nullptr or a size is 0.
+     */
+    FilteredSignalView(const FilterType& filter, const T* source, size_t length, size_t chunkSize = 4096,
+                       size_t cacheChunks = 64)
+        : m_source(source), m_length(length), m_chunkSize(chunkSize), m_capacity(cacheChunks), m_filter(filter) {
+        if (source == nullptr || length == 0 || chunkSize == 0 || cacheChunks == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        m_filter.setState(typename FilterType::State{});
+        if constexpr (!detail::FilterMemory<FilterType>::finite) {
+            m_checkpoints.push_back(typename FilterType::State{});
+        }
+    }
+
+    /**
+     * \brief Reads filtered samples.
+     *
+     * \param begin First sample.
+     * \param end One past the last sample (begin <= end <= length()).
+     * \param output Output of end-begin samples.
+     *
+     * \throws std::out_of_range if the range is outside the signal.
+     * \throws std::invalid_argument if output is nullptr.
+     */
+    void read(size_t begin, size_t end, T* output) {
+        if (begin > end || end > m_length) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        if (output == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        while (begin < end) {
+            size_t chunk = begin / m_chunkSize;
+            size_t offset = begin - chunk * m_chunkSize;
+            const std::vector<T>& data = fetch(chunk);
+            size_t count = std::min(end - begin, data.size() - offset);
+            std::copy(data.begin() + offset, data.begin() + offset + count, output);
+            output += count;
+            begin += count;
+        }
+    }
+
+    /**
+     * \brief Reads filtered samples.
+     *
+     * \param begin First sample.
+     * \param end One past the last sample (begin <= end <= length()).
+     *
+     * \return end-begin filtered samples.
+     *
+     * \throws std::out_of_range if the range is outside the signal.
+     */
+    std::vector<T> read(size_t begin, size_t end) {
+        if (begin > end || end > m_length) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        std::vector<T> result(end - begin);
+        if (!result.empty()) {
+            read(begin, end, result.data());
+        }
+        return result;
+    }
+
+    /// @brief Drops all cached chunks (checkpoints are kept)
+    void clearCache() {
+        m_cache.clear();
+        m_recency.clear();
+    }
+
+    /// @brief Gets number of samples of the signal
+    /// @return Source length
+    size_t length() const { return m_length; }
+
+    /// @brief Gets number of chunk reads served from the cache
+    /// @return Cache hits
+    size_t cacheHits() const { return m_hits; }
+
+    /// @brief Gets number of chunks computed
+    /// @return Cache misses
+    size_t cacheMisses() const { return m_misses; }
+};
+}  // namespace md
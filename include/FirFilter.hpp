@@ -1,7 +1,10 @@
 #pragma once
+#include <algorithm>
 #include <cmath>
 
+#include "FastMath.hpp"
 #include "Filter.hpp"
+#include "ScratchArena.hpp"
 
 namespace md {
 /**
@@ -24,36 +27,69 @@ class FirFilter : public Filter<T, Size> {
     size_t m_head = 0;
 
     /**
-     * \brief Processes a single sample through the FIR filter.
+     * \brief Processes a single sample through a delay line.
      *
      * Implements the FIR convolution algorithm.
      * Stores the input in a circular buffer and computes the weighted sum
      * of the current and past Size-1 samples using the filter coefficients.
      *
+     * \param buffer Circular buffer (updated).
+     * \param head Buffer head position (updated).
+     * \param factors Filter coefficients.
      * \param input Input sample value.
      *
      * \return Filtered output sample.
      */
-    T processSample(T input) override {
-        m_buffer[m_head] = input;
+    static T advance(std::array<T, Size>& buffer, size_t& head, const std::array<T, Size>& factors, T input) {
+        buffer[head] = input;
         T output = 0.0;
-        size_t bufferIdx = m_head;
+        size_t bufferIdx = head;
         for (size_t i = 0; i < Size; i++) {
-            output += m_buffer[bufferIdx] * this->m_factors[i];
+            output += buffer[bufferIdx] * factors[i];
             if (bufferIdx == 0) {
                 bufferIdx = Size - 1;
             } else {
                 bufferIdx--;
             }
         }
-        m_head++;
-        if (m_head >= Size) {
-            m_head = 0;
+        head++;
+        if (head >= Size) {
+            head = 0;
         }
         return output;
     }
 
+    /**
+     * \brief Processes a single sample through the FIR filter.
+     *
+     * \param input Input sample value.
+     *
+     * \return Filtered output sample.
+     */
+    T processSample(T input) override { return advance(m_buffer, m_head, this->m_factors, input); }
+
+    /**
+     * \brief Checks if the delay line has flushed.
+     *
+     * \param epsilon Largest sample magnitude treated as zero.
+     *
+     * \return true if every buffered sample satisfies |x| <= epsilon.
+     */
+    bool isIdle(T epsilon) const override {
+        for (size_t i = 0; i < Size; i++) {
+            if (!(std::abs(m_buffer[i]) <= epsilon)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Clears the delay line, coefficients are kept
+    void clearState() override { reset(); }
+
    public:
+    using Filter<T, Size>::process;
+
     /**
      * \brief Configures the filter as a low-pass filter.
      *
@@ -83,7 +119,7 @@ class FirFilter : public Filter<T, Size> {
                 h = 2.0 * freq;
             } else {
                 T x = 2.0 * M_PI * freq * (n - center);
-                h = std::sin(x) / (M_PI * (n - center));
+                h = FastMath<T>::sin(x) / (M_PI * (n - center));
             }
             this->m_factors[i] = h;
             sum += h;
@@ -138,7 +174,9 @@ class FirFilter : public Filter<T, Size> {
 
         setupLowPass(freqHigh);
 
-        std::array<T, Size> highFactors = this->m_factors;
+        ScratchScope scratch;
+        T* highFactors = scratch.allocate<T>(Size);
+        std::copy(this->m_factors.begin(), this->m_factors.end(), highFactors);
 
         setupLowPass(freqLow);
 
@@ -160,6 +198,97 @@ class FirFilter : public Filter<T, Size> {
         m_head = 0;
     }
 
+    /// \brief Snapshot of the filter state (delay line)
+    struct State {
+        /// @brief Circular buffer contents
+        std::array<T, Size> buffer{};
+        /// @brief Buffer head position
+        size_t head = 0;
+    };
+
+    /**
+     * \brief Gets a copy of the filter state.
+     *
+     * Together with setState() allows processing to be suspended and resumed
+     * at any sample, e.g. from a checkpoint. Coefficients are not included.
+     *
+     * \return Current delay line.
+     */
+    State getState() const { return State{m_buffer, m_head}; }
+
+    /// @brief Gets the delay line, newest sample first
+    /// @return Size state values
+    std::vector<T> getStateValues() const override {
+        std::vector<T> values(Size);
+        for (size_t i = 0; i < Size; i++) {
+            values[i] = m_buffer[(m_head + Size - 1 - i) % Size];
+        }
+        return values;
+    }
+
+    /**
+     * \brief Restores a filter state.
+     *
+     * \param state State returned by getState() (a default State is the cleared state).
+     *
+     * \throws std::invalid_argument if state.head >= Size.
+     */
+    void setState(const State& state) {
+        if (state.head >= Size) {
+            throw std::invalid_argument("Invalid filter state!");
+        }
+        m_buffer = state.buffer;
+        m_head = state.head;
+    }
+
+    /**
+     * \brief Computes the steady state for a constant input.
+     *
+     * Fills the delay line with the level, as if the input had been constant
+     * forever, so an input at that level produces level * sum(h) from the
+     * first sample on instead of a start-up transient.
+     *
+     * \param level Input level, e.g. the first sample of the signal.
+     *
+     * \return State for setState() or process(State&, T*, size_t).
+     */
+    State steadyState(T level) const {
+        State state;
+        state.buffer.fill(level);
+        return state;
+    }
+
+    /// @brief Sets the state to the steady state of a constant input
+    /// @param level Input level, e.g. the first sample of the signal
+    void setSteadyState(T level) { setState(steadyState(level)); }
+
+    /**
+     * \brief Processes a signal array in-place with an external state.
+     *
+     * Uses the coefficients of this filter and the given delay line instead
+     * of its own, so one configured filter can serve many streams whose
+     * states are kept elsewhere, e.g. in a StatePool. The filter itself is
+     * not modified and gating does not apply.
+     *
+     * \param state Delay line of the stream (updated).
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     * \throws std::invalid_argument if state.head >= Size.
+     */
+    void process(State& state, T* signal, size_t length) const {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        if (state.head >= Size) {
+            throw std::invalid_argument("Invalid filter state!");
+        }
+        for (size_t i = 0; i < length; i++) {
+            signal[i] = advance(state.buffer, state.head, this->m_factors, signal[i]);
+        }
+    }
+
     /**
      * \brief Creates a new FIR filter with cleared state.
      *
@@ -171,22 +300,20 @@ class FirFilter : public Filter<T, Size> {
     /**
      * \brief Creates a copy of an existing FIR filter.
      *
-     * Copies the buffer, head position, and coefficients from the source filter.
+     * Copies the buffer, head position, coefficients, and gate settings from the source filter.
      * The copied filter will have the same state and configuration.
      *
      * \param other The source filter to copy from.
      */
-    FirFilter(const FirFilter<T, Size>& other) {
-        m_buffer = other.m_buffer;
-        m_head = other.m_head;
-        this->m_factors = other.m_factors;
-    }
+    FirFilter(const FirFilter<T, Size>& other)
+        : Filter<T, Size>(other), m_buffer(other.m_buffer), m_head(other.m_head) {}
 
     /// @brief Equality comparison operator
     /// @param other Filter to compare with
     /// @return true if filters are equal
     bool operator==(const FirFilter<T, Size>& other) const {
-        return m_buffer == other.m_buffer && m_head == other.m_head && this->m_factors == other.m_factors;
+        return m_buffer == other.m_buffer && m_head == other.m_head && this->m_factors == other.m_factors &&
+               this->isSameGate(other);
     }
 
     /// @brief Inequality comparison operator
@@ -1,4 +1,6 @@
 #pragma once
+#include <cmath>
+
 #include "Filter.hpp"
 
 namespace md {
@@ -24,44 +26,86 @@ class IirFilter : public Filter<T, NumB + NumA> {
     std::array<T, NumA> m_outBuff;
 
     /**
-     * \brief Processes a single sample through the IIR filter.
+     * \brief Processes a single sample through input and output histories.
      *
      * Implements the IIR difference equation.
      * Updates both input and output history buffers.
      *
+     * \param in Input history (updated).
+     * \param out Output history (updated).
+     * \param factors Filter coefficients (b followed by a).
      * \param input Input sample value.
      *
      * \return Filtered output sample.
      */
-    T processSample(T input) override {
+    static T advance(std::array<T, NumB>& in, std::array<T, NumA>& out, const std::array<T, NumB + NumA>& factors,
+                     T input) {
         for (size_t i = NumB - 1; i > 0; i--) {
-            m_inBuff[i] = m_inBuff[i - 1];
+            in[i] = in[i - 1];
         }
-        m_inBuff[0] = input;
+        in[0] = input;
 
         T feedforward = static_cast<T>(0.0);
         for (size_t i = 0; i < NumB; i++) {
-            feedforward += this->m_factors[i] * m_inBuff[i];
+            feedforward += factors[i] * in[i];
         }
 
         T feedback = static_cast<T>(0.0);
         for (size_t i = 0; i < NumA; i++) {
-            feedback += this->m_factors[NumB + i] * m_outBuff[i];
+            feedback += factors[NumB + i] * out[i];
         }
 
         T output = feedforward - feedback;
 
         for (size_t i = NumA - 1; i > 0; i--) {
-            m_outBuff[i] = m_outBuff[i - 1];
+            out[i] = out[i - 1];
         }
         if (NumA > 0) {
-            m_outBuff[0] = output;
+            out[0] = output;
         }
 
         return output;
     }
 
+    /**
+     * \brief Processes a single sample through the IIR filter.
+     *
+     * \param input Input sample value.
+     *
+     * \return Filtered output sample.
+     */
+    T processSample(T input) override { return advance(m_inBuff, m_outBuff, this->m_factors, input); }
+
+    /**
+     * \brief Checks if the input and output histories have decayed.
+     *
+     * \param epsilon Largest sample magnitude treated as zero.
+     *
+     * \return true if every buffered sample satisfies |x| <= epsilon.
+     */
+    bool isIdle(T epsilon) const override {
+        for (size_t i = 0; i < NumB; i++) {
+            if (!(std::abs(m_inBuff[i]) <= epsilon)) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < NumA; i++) {
+            if (!(std::abs(m_outBuff[i]) <= epsilon)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Clears the input and output histories, coefficients are kept
+    void clearState() override {
+        m_inBuff.fill(static_cast<T>(0.0));
+        m_outBuff.fill(static_cast<T>(0.0));
+    }
+
    public:
+    using Filter<T, NumB + NumA>::process;
+
     /**
      * \brief Sets the IIR filter coefficients.
      *
@@ -98,6 +142,100 @@ class IirFilter : public Filter<T, NumB + NumA> {
         this->m_factors.fill(static_cast<T>(0.0));
     }
 
+    /// \brief Snapshot of the filter state (input and output histories)
+    struct State {
+        /// @brief Input history
+        std::array<T, NumB> in{};
+        /// @brief Output history
+        std::array<T, NumA> out{};
+    };
+
+    /**
+     * \brief Gets a copy of the filter state.
+     *
+     * Together with setState() allows processing to be suspended and resumed
+     * at any sample, e.g. from a checkpoint. Coefficients are not included.
+     *
+     * \return Current histories.
+     */
+    State getState() const { return State{m_inBuff, m_outBuff}; }
+
+    /// @brief Gets the input history followed by the output history
+    /// @return NumB + NumA state values
+    std::vector<T> getStateValues() const override {
+        std::vector<T> values(m_inBuff.begin(), m_inBuff.end());
+        values.insert(values.end(), m_outBuff.begin(), m_outBuff.end());
+        return values;
+    }
+
+    /**
+     * \brief Restores a filter state.
+     *
+     * \param state State returned by getState() (a default State is the cleared state).
+     */
+    void setState(const State& state) {
+        m_inBuff = state.in;
+        m_outBuff = state.out;
+    }
+
+    /**
+     * \brief Computes the steady state for a constant input.
+     *
+     * Fills the input history with the level and the output history with
+     * the settled output level * sum(b) / (1 + sum(a)), so an input at that
+     * level continues without a start-up transient.
+     *
+     * \param level Input level, e.g. the first sample of the signal.
+     *
+     * \return State for setState() or process(State&, T*, size_t).
+     *
+     * \throws std::invalid_argument if the filter has a pole at z = 1 (1 + sum(a) = 0).
+     */
+    State steadyState(T level) const {
+        T sumB = static_cast<T>(0.0);
+        for (size_t i = 0; i < NumB; i++) {
+            sumB += this->m_factors[i];
+        }
+        T sumA = static_cast<T>(1.0);
+        for (size_t i = 0; i < NumA; i++) {
+            sumA += this->m_factors[NumB + i];
+        }
+        if (sumA == static_cast<T>(0.0)) {
+            throw std::invalid_argument("Filter has no steady state!");
+        }
+        State state;
+        state.in.fill(level);
+        state.out.fill(level * sumB / sumA);
+        return state;
+    }
+
+    /// @brief Sets the state to the steady state of a constant input
+    /// @param level Input level, e.g. the first sample of the signal
+    void setSteadyState(T level) { setState(steadyState(level)); }
+
+    /**
+     * \brief Processes a signal array in-place with an external state.
+     *
+     * Uses the coefficients of this filter and the given histories instead
+     * of its own, so one configured filter can serve many streams whose
+     * states are kept elsewhere, e.g. in a StatePool. The filter itself is
+     * not modified and gating does not apply.
+     *
+     * \param state Histories of the stream (updated).
+     * \param signal Pointer to the signal array to process.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    void process(State& state, T* signal, size_t length) const {
+        if (signal == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t i = 0; i < length; i++) {
+            signal[i] = advance(state.in, state.out, this->m_factors, signal[i]);
+        }
+    }
+
     /**
      * \brief Creates a new IIR filter with cleared state.
      *
@@ -109,22 +247,20 @@ class IirFilter : public Filter<T, NumB + NumA> {
     /**
      * \brief Creates a copy of an existing IIR filter.
      *
-     * Copies the input buffer, output buffer, and coefficients from the
-     * source filter. The copied filter will have the same state and configuration.
+     * Copies the input buffer, output buffer, coefficients, and gate
+     * settings from the source filter. The copied filter will have the same state and configuration.
      *
      * \param other The source filter to copy from.
      */
-    IirFilter(const IirFilter<T, NumB, NumA>& other) {
-        m_inBuff = other.m_inBuff;
-        m_outBuff = other.m_outBuff;
-        this->m_factors = other.m_factors;
-    }
+    IirFilter(const IirFilter<T, NumB, NumA>& other)
+        : Filter<T, NumB + NumA>(other), m_inBuff(other.m_inBuff), m_outBuff(other.m_outBuff) {}
 
     /// @brief Equality comparison operator
     /// @param other Filter to compare with
     /// @return true if filters are equal
     bool operator==(const IirFilter<T, NumB, NumA>& other) const {
-        return m_inBuff == other.m_inBuff && m_outBuff == other.m_outBuff && this->m_factors == other.m_factors;
+        return m_inBuff == other.m_inBuff && m_outBuff == other.m_outBuff && this->m_factors == other.m_factors &&
+               this->isSameGate(other);
     }
 
     /// @brief Inequality comparison operator
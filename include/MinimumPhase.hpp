@@ -0,0 +1,249 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "FastMath.hpp"
+#include "Fft.hpp"
+#include "FirFilter.hpp"
+
+namespace md {
+/**
+ * \brief Converts FIR designs to minimum phase and reports their group delay.
+ *
+ * The windowed-sinc designs of FirFilter are linear phase and delay every
+ * frequency by (Size-1)/2 samples. The minimum-phase filter with the same
+ * magnitude response has the smallest possible delay and is obtained here
+ * with the homomorphic (cepstral) method: the real cepstrum of log|H| is
+ * folded onto positive quefrencies and exponentiated back, which gives the
+ * causal filter whose log-magnitude equals log|H|. The magnitude is taken
+ * from an FFT of fftSize() points; log|H| is clamped at a small fraction of
+ * the peak so that zeros on the unit circle (stopband nulls) stay finite.
+ *
+ * The result can be truncated to fewer taps: the energy of a minimum-phase
+ * filter is concentrated in its first taps, so shortening it disturbs the
+ * magnitude response far less than shortening the linear-phase design.
+ * groupDelay() and meanGroupDelay() report the delay before and after
+ * conversion, so latency can be traded against length explicitly.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class MinimumPhase {
+   private:
+    /// \brief Transform used for spectra and cepstra
+    Fft<T> m_fft;
+    /// \brief Transform work buffer
+    std::vector<std::complex<T>> m_work;
+    /// \brief Second work buffer (group delay)
+    std::vector<std::complex<T>> m_ramp;
+
+    /**
+     * \brief Loads zero-padded coefficients into a work buffer.
+     *
+     * \param factors Filter coefficients.
+     * \param buffer Buffer of fftSize() elements.
+     *
+     * \throws std::invalid_argument if factors is empty or longer than fftSize()/2.
+     */
+    void load(const std::vector<T>& factors, std::vector<std::complex<T>>& buffer) const {
+        if (factors.empty() || 2 * factors.size() > m_fft.size()) {
+            throw std::invalid_argument("Filter length must be in range (0, fftSize/2]!");
+        }
+        std::fill(buffer.begin(), buffer.end(), std::complex<T>(0.0));
+        for (size_t n = 0; n < factors.size(); n++) {
+            buffer[n] = factors[n];
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a converter.
+     *
+     * Longer transforms reduce cepstral aliasing; 16 to 32 times the filter
+     * length is a good choice for designs with deep stopbands.
+     *
+     * \param fftSize Transform length (power of two, >= twice the filter length).
+     *
+     * \throws std::invalid_argument if fftSize is not a power of two.
+     */
+    explicit MinimumPhase(size_t fftSize = 4096) : m_fft(fftSize), m_work(fftSize), m_ramp(fftSize) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+    }
+
+    /**
+     * \brief Computes the minimum-phase filter with the magnitude response of a design.
+     *
+     * \param factors Filter coefficients [h0, h1, ..., h(N-1)].
+     * \param outSize Number of taps of the result (0 = same as input).
+     *
+     * \return Minimum-phase coefficients, truncated to outSize taps.
+     *
+     * \throws std::invalid_argument if factors is empty or longer than fftSize()/2.
+     */
+    std::vector<T> convert(const std::vector<T>& factors, size_t outSize = 0) {
+        const size_t size = m_fft.size();
+        if (outSize == 0) {
+            outSize = factors.size();
+        }
+        outSize = std::min(outSize, size);
+        load(factors, m_work);
+        m_fft.forward(m_work.data());
+
+        T peak = 0;
+        for (size_t k = 0; k < size; k++) {
+            peak = std::max(peak, std::abs(m_work[k]));
+        }
+        if (peak == static_cast<T>(0.0)) {
+            return std::vector<T>(outSize, static_cast<T>(0.0));
+        }
+        const T floor = peak * std::sqrt(std::numeric_limits<T>::epsilon());
+        for (size_t k = 0; k < size; k++) {
+            m_work[k] = FastMath<T>::log(std::max(std::abs(m_work[k]), floor));
+        }
+
+        // Real cepstrum, folded onto positive quefrencies
+        m_fft.inverse(m_work.data());
+        for (size_t n = 1; n < size / 2; n++) {
+            m_work[n] = static_cast<T>(2.0) * m_work[n].real();
+            m_work[size - n] = 0;
+        }
+        m_work[0] = m_work[0].real();
+        m_work[size / 2] = m_work[size / 2].real();
+
+        m_fft.forward(m_work.data());
+        for (size_t k = 0; k < size; k++) {
+            T s;
+            T c;
+            FastMath<T>::sincos(m_work[k].imag(), s, c);
+            m_work[k] = FastMath<T>::exp(m_work[k].real()) * std::complex<T>(c, s);
+        }
+        m_fft.inverse(m_work.data());
+
+        std::vector<T> result(outSize);
+        for (size_t n = 0; n < outSize; n++) {
+            result[n] = m_work[n].real();
+        }
+        return result;
+    }
+
+    /**
+     * \brief Converts a FIR filter design to minimum phase.
+     *
+     * \tparam OutSize Number of taps of the result (<= Size for a shorter filter).
+     * \tparam Size Number of taps of the design.
+     * \param filter Designed filter, e.g. after setupLowPass().
+     *
+     * \return Minimum-phase filter with the same magnitude response.
+     *
+     * \throws std::invalid_argument if Size is larger than fftSize()/2.
+     */
+    template <size_t OutSize, size_t Size>
+    FirFilter<T, OutSize> convert(const FirFilter<T, Size>& filter) {
+        std::array<T, Size> factors = filter.getFactors();
+        std::vector<T> result = convert(std::vector<T>(factors.begin(), factors.end()), OutSize);
+        std::array<T, OutSize> taps{};
+        std::copy(result.begin(), result.end(), taps.begin());
+        FirFilter<T, OutSize> converted;
+        converted.setFactors(taps);
+        return converted;
+    }
+
+    /**
+     * \brief Computes the group delay of a filter.
+     *
+     * Uses tau(w) = Re{ DFT(n * h[n]) / DFT(h[n]) }.
+     *
+     * \param factors Filter coefficients.
+     *
+     * \return Group delay in samples for bins 0..fftSize()/2 (bin k is frequency
+     *         k / fftSize() of the sample rate); 0 where |H| is below 1e-3 of its peak.
+     *
+     * \throws std::invalid_argument if factors is empty or longer than fftSize()/2.
+     */
+    std::vector<T> groupDelay(const std::vector<T>& factors) {
+        const size_t size = m_fft.size();
+        load(factors, m_work);
+        load(factors, m_ramp);
+        for (size_t n = 0; n < factors.size(); n++) {
+            m_ramp[n] *= static_cast<T>(n);
+        }
+        m_fft.forward(m_work.data());
+        m_fft.forward(m_ramp.data());
+
+        T peak = 0;
+        for (size_t k = 0; k <= size / 2; k++) {
+            peak = std::max(peak, std::norm(m_work[k]));
+        }
+        const T floor = peak * static_cast<T>(1e-6);
+        std::vector<T> delay(size / 2 + 1, static_cast<T>(0.0));
+        for (size_t k = 0; k <= size / 2; k++) {
+            T power = std::norm(m_work[k]);
+            if (power > floor && power > static_cast<T>(0.0)) {
+                delay[k] = (m_ramp[k] * std::conj(m_work[k])).real() / power;
+            }
+        }
+        return delay;
+    }
+
+    /**
+     * \brief Computes the energy-weighted mean group delay of a filter.
+     *
+     * Averages the group delay over frequency with weights |H|^2, i.e. it is
+     * the delay seen by signals in the passband. Equals (N-1)/2 for a
+     * symmetric linear-phase design.
+     *
+     * \param factors Filter coefficients.
+     *
+     * \return Mean group delay in samples.
+     *
+     * \throws std::invalid_argument if factors is empty or longer than fftSize()/2.
+     */
+    T meanGroupDelay(const std::vector<T>& factors) {
+        std::vector<T> delay = groupDelay(factors);
+        T weighted = 0;
+        T total = 0;
+        for (size_t k = 0; k < delay.size(); k++) {
+            T power = std::norm(m_work[k]);
+            weighted += delay[k] * power;
+            total += power;
+        }
+        return total > static_cast<T>(0.0) ? weighted / total : static_cast<T>(0.0);
+    }
+
+    /**
+     * \brief Computes the group delay of a FIR filter.
+     *
+     * \param filter Filter to analyze.
+     *
+     * \return Group delay in samples for bins 0..fftSize()/2.
+     */
+    template <size_t Size>
+    std::vector<T> groupDelay(const FirFilter<T, Size>& filter) {
+        std::array<T, Size> factors = filter.getFactors();
+        return groupDelay(std::vector<T>(factors.begin(), factors.end()));
+    }
+
+    /**
+     * \brief Computes the energy-weighted mean group delay of a FIR filter.
+     *
+     * \param filter Filter to analyze.
+     *
+     * \return Mean group delay in samples.
+     */
+    template <size_t Size>
+    T meanGroupDelay(const FirFilter<T, Size>& filter) {
+        std::array<T, Size> factors = filter.getFactors();
+        return meanGroupDelay(std::vector<T>(factors.begin(), factors.end()));
+    }
+
+    /// @brief Gets transform length
+    /// @return Number of FFT points
+    size_t fftSize() const { return m_fft.size(); }
+};
+}  // namespace md
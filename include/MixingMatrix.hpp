@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+
+namespace md {
+/**
+ * \brief Multichannel mixing matrix (M inputs x N outputs).
+ *
+ * Computes out[o][t] = sum_i gain[o][i] * in[i][t] for planar or interleaved
+ * multichannel blocks in a single pass over memory, replacing chains of
+ * Signal::operator+= and scaled temporaries. For every output only the
+ * non-zero gains are kept in a compact list, so routing and downmix matrices
+ * that are mostly zero cost only their non-zero entries. The kernel is
+ * register-blocked over four inputs: each output sample is loaded and stored
+ * once per four multiply-adds.
+ *
+ * Gain changes can be ramped: setGains() with a ramp length interpolates
+ * every entry linearly from its current to its new value, sample by sample,
+ * which avoids clicks and zipper noise when routing changes.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class MixingMatrix {
+   private:
+    /// @brief Number of frames mixed per pass for interleaved data
+    static constexpr size_t kBlock = 256;
+    /// @brief Number of inputs accumulated per pass over an output
+    static constexpr size_t kInputTile = 4;
+
+    /// \brief Non-zero matrix entry of one output
+    struct Entry {
+        /// @brief Input channel
+        size_t input;
+        /// @brief Current gain
+        T gain;
+        /// @brief Gain increment per sample while ramping
+        T step;
+    };
+
+    /// \brief Number of input channels
+    size_t m_numInputs = 0;
+    /// \brief Number of output channels
+    size_t m_numOutputs = 0;
+    /// \brief Target gains, row-major [output][input]
+    std::vector<T> m_target;
+    /// \brief Active entries per output (capacity reserved for all inputs)
+    std::vector<std::vector<Entry>> m_entries;
+    /// \brief Remaining samples of the current ramp
+    size_t m_rampRemaining = 0;
+    /// \brief Planar scratch for interleaved input
+    AlignedBuffer<T> m_inScratch;
+    /// \brief Planar scratch for interleaved output
+    AlignedBuffer<T> m_outScratch;
+    /// \brief Channel pointers into the scratch buffers
+    std::vector<const T*> m_inRows;
+    /// \brief Channel pointers into the scratch buffers
+    std::vector<T*> m_outRows;
+
+    /**
+     * \brief Rebuilds the entry lists from current gains and targets.
+     *
+     * \param current Current gain of every matrix element.
+     * \param rampLength Number of samples to reach the targets (0 = immediately).
+     */
+    void rebuild(const std::vector<T>& current, size_t rampLength) {
+        for (size_t o = 0; o < m_numOutputs; o++) {
+            m_entries[o].clear();
+            for (size_t i = 0; i < m_numInputs; i++) {
+                T from = current[o * m_numInputs + i];
+                T to = m_target[o * m_numInputs + i];
+                if (rampLength == 0) {
+                    from = to;
+                }
+                if (from == static_cast<T>(0.0) && to == static_cast<T>(0.0)) {
+                    continue;
+                }
+                T step = rampLength == 0 ? static_cast<T>(0.0) : (to - from) / static_cast<T>(rampLength);
+                m_entries[o].push_back(Entry{i, from, step});
+            }
+        }
+        m_rampRemaining = rampLength;
+    }
+
+    /**
+     * \brief Mixes a block with constant gains.
+     *
+     * \param inputs Input channel pointers.
+     * \param outputs Output channel pointers.
+     * \param offset First sample of the block.
+     * \param count Number of samples.
+     */
+    void mixStatic(const T* const* inputs, T* const* outputs, size_t offset, size_t count) const {
+        for (size_t o = 0; o < m_numOutputs; o++) {
+            T* out = outputs[o] + offset;
+            const std::vector<Entry>& entries = m_entries[o];
+            if (entries.empty()) {
+                std::fill(out, out + count, static_cast<T>(0.0));
+                continue;
+            }
+            size_t e = 0;
+            for (; e + kInputTile <= entries.size(); e += kInputTile) {
+                const T* x0 = inputs[entries[e].input] + offset;
+                const T* x1 = inputs[entries[e + 1].input] + offset;
+                const T* x2 = inputs[entries[e + 2].input] + offset;
+                const T* x3 = inputs[entries[e + 3].input] + offset;
+                const T g0 = entries[e].gain;
+                const T g1 = entries[e + 1].gain;
+                const T g2 = entries[e + 2].gain;
+                const T g3 = entries[e + 3].gain;
+                if (e == 0) {
+                    for (size_t t = 0; t < count; t++) {
+                        out[t] = g0 * x0[t] + g1 * x1[t] + g2 * x2[t] + g3 * x3[t];
+                    }
+                } else {
+                    for (size_t t = 0; t < count; t++) {
+                        out[t] += g0 * x0[t] + g1 * x1[t] + g2 * x2[t] + g3 * x3[t];
+                    }
+                }
+            }
+            for (; e < entries.size(); e++) {
+                const T* x = inputs[entries[e].input] + offset;
+                const T g = entries[e].gain;
+                if (e == 0) {
+                    for (size_t t = 0; t < count; t++) {
+                        out[t] = g * x[t];
+                    }
+                } else {
+                    for (size_t t = 0; t < count; t++) {
+                        out[t] += g * x[t];
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Mixes a block while gains move towards their targets.
+     *
+     * \param inputs Input channel pointers.
+     * \param outputs Output channel pointers.
+     * \param offset First sample of the block.
+     * \param count Number of samples (<= remaining ramp length).
+     */
+    void mixRamp(const T* const* inputs, T* const* outputs, size_t offset, size_t count) {
+        for (size_t o = 0; o < m_numOutputs; o++) {
+            T* out = outputs[o] + offset;
+            std::fill(out, out + count, static_cast<T>(0.0));
+            for (Entry& entry : m_entries[o]) {
+                const T* x = inputs[entry.input] + offset;
+                const T g = entry.gain;
+                const T step = entry.step;
+                for (size_t t = 0; t < count; t++) {
+                    out[t] += (g + step * static_cast<T>(t + 1)) * x[t];
+                }
+                entry.gain = g + step * static_cast<T>(count);
+            }
+        }
+        m_rampRemaining -= count;
+        if (m_rampRemaining == 0) {
+            rebuild(m_target, 0);
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a mixing matrix with all gains set to zero.
+     *
+     * \param numInputs Number of input channels (M).
+     * \param numOutputs Number of output channels (N).
+     *
+     * \throws std::invalid_argument if numInputs or numOutputs is 0.
+     */
+    MixingMatrix(size_t numInputs, size_t numOutputs) : m_numInputs(numInputs), m_numOutputs(numOutputs) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+        if (numInputs == 0 || numOutputs == 0) {
+            throw std::invalid_argument("Number of channels must be positive!");
+        }
+        m_target.assign(numInputs * numOutputs, static_cast<T>(0.0));
+        m_entries.resize(numOutputs);
+        for (std::vector<Entry>& entries : m_entries) {
+            entries.reserve(numInputs);
+        }
+        m_inScratch.resize(kBlock * numInputs);
+        m_outScratch.resize(kBlock * numOutputs);
+        m_inRows.resize(numInputs);
+        m_outRows.resize(numOutputs);
+        for (size_t i = 0; i < numInputs; i++) {
+            m_inRows[i] = m_inScratch.data() + i * kBlock;
+        }
+        for (size_t o = 0; o < numOutputs; o++) {
+            m_outRows[o] = m_outScratch.data() + o * kBlock;
+        }
+    }
+
+    /**
+     * \brief Sets all gains, optionally with a linear ramp.
+     *
+     * \param gains Row-major N x M matrix, gains[o * M + i] routes input i to output o.
+     * \param rampLength Number of samples over which gains move to the new values
+     *                   (0 = change immediately).
+     *
+     * \throws std::invalid_argument if gains does not have M x N elements.
+     */
+    void setGains(const std::vector<T>& gains, size_t rampLength = 0) {
+        if (gains.size() != m_numInputs * m_numOutputs) {
+            throw std::invalid_argument("Gain matrix must have numInputs x numOutputs elements!");
+        }
+        std::vector<T> current = getCurrentGains();
+        m_target = gains;
+        rebuild(current, rampLength);
+    }
+
+    /**
+     * \brief Gets the target gains.
+     *
+     * \return Row-major N x M matrix.
+     */
+    std::vector<T> getGains() const { return m_target; }
+
+    /**
+     * \brief Gets the gains in effect right now (differs from getGains() while ramping).
+     *
+     * \return Row-major N x M matrix.
+     */
+    std::vector<T> getCurrentGains() const {
+        std::vector<T> current(m_numInputs * m_numOutputs, static_cast<T>(0.0));
+        for (size_t o = 0; o < m_numOutputs; o++) {
+            for (const Entry& entry : m_entries[o]) {
+                current[o * m_numInputs + entry.input] = entry.gain;
+            }
+        }
+        return current;
+    }
+
+    /**
+     * \brief Mixes planar channel blocks.
+     *
+     * \param inputs numInputs() pointers to input channels.
+     * \param outputs numOutputs() pointers to output channels (must not alias inputs).
+     * \param length Number of samples per channel.
+     *
+     * \throws std::invalid_argument if a pointer is nullptr or length is 0.
+     */
+    void process(const T* const* inputs, T* const* outputs, size_t length) {
+        if (inputs == nullptr || outputs == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        size_t pos = 0;
+        if (m_rampRemaining > 0) {
+            size_t count = std::min(length, m_rampRemaining);
+            mixRamp(inputs, outputs, 0, count);
+            pos = count;
+        }
+        if (pos < length) {
+            mixStatic(inputs, outputs, pos, length - pos);
+        }
+    }
+
+    /**
+     * \brief Mixes interleaved frames.
+     *
+     * Deinterleaves blocks of frames into planar scratch buffers allocated at
+     * construction, mixes them and interleaves the result.
+     *
+     * \param input Interleaved input, frames x numInputs() samples.
+     * \param output Interleaved output, frames x numOutputs() samples.
+     * \param frames Number of frames.
+     *
+     * \throws std::invalid_argument if a pointer is nullptr or frames is 0.
+     */
+    void processInterleaved(const T* input, T* output, size_t frames) {
+        if (input == nullptr || output == nullptr || frames == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t pos = 0; pos < frames; pos += kBlock) {
+            size_t count = std::min(kBlock, frames - pos);
+            const T* in = input + pos * m_numInputs;
+            for (size_t t = 0; t < count; t++) {
+                for (size_t i = 0; i < m_numInputs; i++) {
+                    m_inScratch[i * kBlock + t] = in[t * m_numInputs + i];
+                }
+            }
+            process(m_inRows.data(), m_outRows.data(), count);
+            T* out = output + pos * m_numOutputs;
+            for (size_t t = 0; t < count; t++) {
+                for (size_t o = 0; o < m_numOutputs; o++) {
+                    out[t * m_numOutputs + o] = m_outScratch[o * kBlock + t];
+                }
+            }
+        }
+    }
+
+    /// @brief Gets number of input channels
+    /// @return M
+    size_t numInputs() const { return m_numInputs; }
+
+    /// @brief Gets number of output channels
+    /// @return N
+    size_t numOutputs() const { return m_numOutputs; }
+
+    /// @brief Checks if a gain ramp is in progress
+    /// @return true while gains are moving
+    bool isRamping() const { return m_rampRemaining > 0; }
+};
+}  // namespace md
@@ -0,0 +1,256 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+
+namespace md {
+/**
+ * \brief Bank of FIR filters evaluated over one shared input.
+ *
+ * Runs K FIR designs (e.g. band-passes from FirFilter::setupBandPass) on the
+ * same input signal and writes K output signals. Instead of K independent
+ * filters, each with its own delay line and its own pass over the input, the
+ * bank keeps a single linear delay line and evaluates all filters with a
+ * GEMM-like kernel: the K x Size coefficient matrix is multiplied by the
+ * Toeplitz matrix of input windows. The kernel is register-blocked over
+ * kFilterTile filters and kTimeTile outputs, so every input load feeds
+ * kFilterTile multiply-adds, and cache-blocked by sweeping one block of input
+ * per group of filters while their coefficients stay hot.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class MultiFirFilter {
+   private:
+    /// @brief Number of filters evaluated together
+    static constexpr size_t kFilterTile = 4;
+    /// @brief Number of output samples evaluated together
+    static constexpr size_t kTimeTile = 8;
+    /// @brief Minimum number of samples processed per kernel call
+    static constexpr size_t kMinBlock = 256;
+
+    /// \brief Number of filters
+    size_t m_numFilters = 0;
+    /// \brief Number of coefficients per filter
+    size_t m_size = 0;
+    /// \brief Number of coefficients rounded up to SIMD lanes
+    size_t m_padded = 0;
+    /// \brief Number of input samples processed per kernel call
+    size_t m_block = 0;
+    /// \brief Time-reversed coefficients, one padded row per filter
+    AlignedBuffer<T> m_coeffs;
+    /// \brief Shared linear delay line: m_padded-1 history samples followed by a block
+    AlignedBuffer<T> m_work;
+    /// \brief Row pointers used by the contiguous-output overload of process()
+    std::vector<T*> m_rows;
+
+    /**
+     * \brief Evaluates a tile of Filters filters for one block of input.
+     *
+     * \tparam Filters Number of filters in the tile (1..kFilterTile).
+     * \param filter First filter of the tile.
+     * \param count Number of outputs to compute.
+     * \param outputs Output arrays, one per filter.
+     * \param offset Position of the block in the output arrays.
+     */
+    template <size_t Filters>
+    void kernel(size_t filter, size_t count, T* const* outputs, size_t offset) const {
+        const T* work = m_work.data();
+        const size_t first = m_padded - m_size;
+        const T* rows[Filters];
+        for (size_t f = 0; f < Filters; f++) {
+            rows[f] = m_coeffs.data() + (filter + f) * m_padded;
+        }
+        size_t j = 0;
+        for (; j + kTimeTile <= count; j += kTimeTile) {
+            T acc[Filters][kTimeTile] = {};
+            for (size_t k = first; k < m_padded; k++) {
+                const T* x = work + j + k;
+                for (size_t f = 0; f < Filters; f++) {
+                    const T c = rows[f][k];
+                    for (size_t t = 0; t < kTimeTile; t++) {
+                        acc[f][t] += c * x[t];
+                    }
+                }
+            }
+            for (size_t f = 0; f < Filters; f++) {
+                std::copy(acc[f], acc[f] + kTimeTile, outputs[filter + f] + offset + j);
+            }
+        }
+        for (; j < count; j++) {
+            for (size_t f = 0; f < Filters; f++) {
+                T acc = static_cast<T>(0.0);
+                for (size_t k = first; k < m_padded; k++) {
+                    acc += rows[f][k] * work[j + k];
+                }
+                outputs[filter + f][offset + j] = acc;
+            }
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a bank of zeroed filters.
+     *
+     * \param numFilters Number of filters (K).
+     * \param size Number of coefficients of the longest filter.
+     *
+     * \throws std::invalid_argument if numFilters or size is 0.
+     */
+    MultiFirFilter(size_t numFilters, size_t size) : m_numFilters(numFilters), m_size(size) {
+        if (numFilters == 0 || size == 0) {
+            throw std::invalid_argument("Size must be positive!");
+        }
+        m_padded = paddedLength<T>(size);
+        m_block = std::max(kMinBlock, m_padded);
+        m_coeffs.resize(numFilters * m_padded);
+        m_work.resize(m_padded - 1 + m_block);
+        m_rows.resize(numFilters);
+    }
+
+    /**
+     * \brief Sets the coefficients of one filter.
+     *
+     * Shorter filters are zero-extended to size().
+     *
+     * \param filter Filter index.
+     * \param factors Filter coefficients [h0, h1, ...] (at most size() values).
+     *
+     * \throws std::out_of_range if filter >= numFilters().
+     * \throws std::invalid_argument if factors has more than size() values.
+     */
+    void setFactors(size_t filter, const std::vector<T>& factors) {
+        if (filter >= m_numFilters) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        if (factors.size() > m_size) {
+            throw std::invalid_argument("Too many coefficients!");
+        }
+        T* row = m_coeffs.data() + filter * m_padded;
+        std::fill(row, row + m_padded, static_cast<T>(0.0));
+        for (size_t i = 0; i < factors.size(); i++) {
+            row[m_padded - 1 - i] = factors[i];
+        }
+    }
+
+    /**
+     * \brief Sets the coefficients of one filter from a fixed-size design.
+     *
+     * \tparam Size Number of coefficients of the design.
+     * \param filter Filter index.
+     * \param factors Coefficients, e.g. FirFilter::getFactors().
+     *
+     * \throws std::out_of_range if filter >= numFilters().
+     * \throws std::invalid_argument if Size > size().
+     */
+    template <size_t Size>
+    void setFactors(size_t filter, const std::array<T, Size>& factors) {
+        setFactors(filter, std::vector<T>(factors.begin(), factors.end()));
+    }
+
+    /**
+     * \brief Gets the coefficients of one filter.
+     *
+     * \param filter Filter index.
+     *
+     * \return size() coefficients in natural order.
+     *
+     * \throws std::out_of_range if filter >= numFilters().
+     */
+    std::vector<T> getFactors(size_t filter) const {
+        if (filter >= m_numFilters) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        const T* row = m_coeffs.data() + filter * m_padded;
+        std::vector<T> factors(m_size);
+        for (size_t i = 0; i < m_size; i++) {
+            factors[i] = row[m_padded - 1 - i];
+        }
+        return factors;
+    }
+
+    /**
+     * \brief Filters one input block with every filter of the bank.
+     *
+     * The bank keeps the last Size-1 inputs as shared history, so consecutive
+     * calls continue the signal like Filter::process().
+     *
+     * \param input Pointer to the input block (not modified).
+     * \param length Number of samples in the block.
+     * \param outputs numFilters() output arrays of at least length samples.
+     *
+     * \throws std::invalid_argument if a pointer is nullptr or length is 0.
+     */
+    void process(const T* input, size_t length, T* const* outputs) {
+        if (input == nullptr || outputs == nullptr || length == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t f = 0; f < m_numFilters; f++) {
+            if (outputs[f] == nullptr) {
+                throw std::invalid_argument("Bad array!");
+            }
+        }
+        const size_t history = m_padded - 1;
+        T* work = m_work.data();
+        for (size_t pos = 0; pos < length; pos += m_block) {
+            size_t count = std::min(m_block, length - pos);
+            std::copy(input + pos, input + pos + count, work + history);
+            size_t f = 0;
+            for (; f + kFilterTile <= m_numFilters; f += kFilterTile) {
+                kernel<kFilterTile>(f, count, outputs, pos);
+            }
+            switch (m_numFilters - f) {
+                case 3:
+                    kernel<3>(f, count, outputs, pos);
+                    break;
+                case 2:
+                    kernel<2>(f, count, outputs, pos);
+                    break;
+                case 1:
+                    kernel<1>(f, count, outputs, pos);
+                    break;
+                default:
+                    break;
+            }
+            std::copy(work + count, work + count + history, work);
+        }
+    }
+
+    /**
+     * \brief Filters one input block into a contiguous output matrix.
+     *
+     * \param input Pointer to the input block (not modified).
+     * \param length Number of samples in the block.
+     * \param output Output matrix, numFilters() rows of length samples.
+     *
+     * \throws std::invalid_argument if a pointer is nullptr or length is 0.
+     */
+    void process(const T* input, size_t length, T* output) {
+        if (output == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        for (size_t f = 0; f < m_numFilters; f++) {
+            m_rows[f] = output + f * length;
+        }
+        process(input, length, m_rows.data());
+    }
+
+    /**
+     * \brief Resets the bank to its initial state.
+     *
+     * Clears the shared delay line. Coefficients are not affected.
+     */
+    void reset() { m_work.fill(static_cast<T>(0.0)); }
+
+    /// @brief Gets number of filters
+    /// @return K
+    size_t numFilters() const { return m_numFilters; }
+
+    /// @brief Gets filter length
+    /// @return Number of coefficients per filter
+    size_t size() const { return m_size; }
+};
+}  // namespace md
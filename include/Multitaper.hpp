@@ -0,0 +1,275 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "Dpss.hpp"
+#include "Fft.hpp"
+#include "ThreadPool.hpp"
+
+namespace md {
+/**
+ * \brief Thomson multitaper power spectral density estimator.
+ *
+ * Multiplies one record by K orthogonal Slepian tapers, transforms each
+ * tapered copy and combines the K eigenspectra |Y_k(f)|^2. The eigenspectra
+ * are nearly uncorrelated, so the estimate has about 2K degrees of freedom
+ * from a single record, with leakage confined to the band |f| < NW / N.
+ * This suits short records, where averaging segments (Welch) would cost
+ * too much resolution.
+ *
+ * The tapers come from the shared Dpss cache and are computed once per
+ * (N, NW, K). The K tapered FFTs are distributed over a ThreadPool, each
+ * worker with its own RealFft and buffers.
+ *
+ * With adaptive weighting (the default), each bin weights the eigenspectra
+ * by d_k^2, d_k = sqrt(lambda_k) S / (lambda_k S + (1 - lambda_k) sigma^2),
+ * iterated to a fixed point. Higher-order tapers, which leak more, are then
+ * discounted wherever the spectrum is weak, which keeps the estimate
+ * unbiased over a large dynamic range. Without it, the eigenspectra are
+ * averaged with equal weights.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class MultitaperPsd {
+   private:
+    /// @brief Maximum number of adaptive weighting iterations per bin
+    static constexpr int kMaxIterations = 100;
+
+    /// \brief Per-worker buffers
+    struct Worker {
+        /// @brief Real FFT (holds its own work buffer)
+        RealFft<T> fft;
+        /// @brief Tapered, zero-padded record
+        AlignedBuffer<T> frame;
+        /// @brief Spectrum of the tapered record
+        std::vector<std::complex<T>> spectrum;
+
+        /// @brief Creates buffers for one FFT size
+        /// @param size FFT size
+        explicit Worker(size_t size) : fft(size), frame(size), spectrum(size / 2 + 1) {}
+    };
+
+    /// \brief Slepian tapers
+    std::shared_ptr<const Dpss<T>> m_tapers;
+    /// \brief FFT size
+    size_t m_fftSize;
+    /// \brief Number of bins
+    size_t m_bins;
+    /// \brief Sampling frequency in Hz
+    T m_sampleRate;
+    /// \brief Adaptive weighting flag
+    bool m_adaptive = true;
+    /// \brief Worker threads
+    std::unique_ptr<ThreadPool> m_pool;
+    /// \brief Buffers of each worker
+    std::vector<Worker> m_workers;
+    /// \brief Eigenspectra |Y_k|^2, [taper][bin]
+    AlignedBuffer<T> m_eigenspectra;
+    /// \brief Estimated density of each bin
+    AlignedBuffer<T> m_psd;
+    /// \brief Degrees of freedom of each bin
+    AlignedBuffer<T> m_dof;
+
+    /**
+     * \brief Combines the eigenspectra of a range of bins.
+     *
+     * \param begin First bin.
+     * \param end One past the last bin.
+     * \param variance Mean square of the record (sigma^2 in units of |Y_k|^2).
+     */
+    void combine(size_t begin, size_t end, T variance) {
+        const size_t count = m_tapers->count();
+        const std::vector<T>& lambda = m_tapers->concentrations();
+        const T tolerance = std::sqrt(std::numeric_limits<T>::epsilon());
+        for (size_t bin = begin; bin < end; bin++) {
+            const T* spectra = m_eigenspectra.data() + bin;
+            T estimate = static_cast<T>(0.0);
+            for (size_t k = 0; k < count; k++) {
+                estimate += spectra[k * m_bins];
+            }
+            estimate /= static_cast<T>(count);
+            T dof = static_cast<T>(2 * count);
+            if (m_adaptive && count > 1 && variance > 0) {
+                // Start from the two best-concentrated tapers
+                estimate = (spectra[0] + spectra[m_bins]) / 2;
+                for (int iteration = 0; iteration < kMaxIterations; iteration++) {
+                    T sum = static_cast<T>(0.0);
+                    T weights = static_cast<T>(0.0);
+                    T weightsSquared = static_cast<T>(0.0);
+                    for (size_t k = 0; k < count; k++) {
+                        T denominator = lambda[k] * estimate + (1 - lambda[k]) * variance;
+                        T weight = lambda[k] * estimate * estimate / (denominator * denominator);
+                        sum += weight * spectra[k * m_bins];
+                        weights += weight;
+                        weightsSquared += weight * weight;
+                    }
+                    if (!(weights > 0)) {
+                        break;
+                    }
+                    T next = sum / weights;
+                    dof = 2 * weights * weights / weightsSquared;
+                    bool converged = std::abs(next - estimate) <= tolerance * next;
+                    estimate = next;
+                    if (converged) {
+                        break;
+                    }
+                }
+            }
+            m_psd[bin] = estimate;
+            m_dof[bin] = dof;
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates an estimator.
+     *
+     * \param length Record length N (>= 2).
+     * \param bandwidth Time-bandwidth product NW (0 < NW < N/2), resolution is 2 * NW * sampleRate / N.
+     * \param numTapers Number of tapers K (0 = 2 * NW - 1, at least 1).
+     * \param sampleRate Sampling frequency in Hz (used for density scaling).
+     * \param numThreads Number of worker threads (0 = hardware concurrency).
+     * \param fftSize FFT size (power of two >= N, 0 = smallest such size).
+     *
+     * \throws std::invalid_argument if a parameter is out of range.
+     */
+    MultitaperPsd(size_t length, T bandwidth, size_t numTapers, T sampleRate, size_t numThreads = 0,
+                  size_t fftSize = 0)
+        : m_sampleRate(sampleRate) {
+        if (length < 2 || !(bandwidth > 0) || !(sampleRate > 0)) {
+            throw std::invalid_argument("Invalid spectral estimation parameters!");
+        }
+        if (numTapers == 0) {
+            numTapers = static_cast<size_t>(std::max<T>(1, std::floor(2 * bandwidth) - 1));
+        }
+        m_tapers = Dpss<T>::get(length, bandwidth, numTapers);
+        if (fftSize == 0) {
+            fftSize = 2;
+            while (fftSize < length) {
+                fftSize *= 2;
+            }
+        }
+        if (fftSize < length || (fftSize & (fftSize - 1)) != 0) {
+            throw std::invalid_argument("Invalid spectral estimation parameters!");
+        }
+        m_fftSize = fftSize;
+        m_bins = fftSize / 2 + 1;
+        m_pool = std::make_unique<ThreadPool>(numThreads);
+        m_workers.reserve(m_pool->size());
+        for (size_t i = 0; i < m_pool->size(); i++) {
+            m_workers.emplace_back(fftSize);
+        }
+        m_eigenspectra.resize(numTapers * m_bins);
+        m_psd.resize(m_bins);
+        m_dof.resize(m_bins);
+    }
+
+    /**
+     * \brief Estimates the power spectral density of a record.
+     *
+     * Uses one-sided density scaling: P(f) = 2 * S(f) / sampleRate with
+     * unit-energy tapers, without doubling at DC and Nyquist.
+     *
+     * \param signal Pointer to the record.
+     * \param length Number of samples (must equal length()).
+     *
+     * \throws std::invalid_argument if signal is nullptr or length != length().
+     */
+    void compute(const T* signal, size_t length) {
+        const size_t n = m_tapers->length();
+        if (signal == nullptr || length != n) {
+            throw std::invalid_argument("Bad array!");
+        }
+        m_pool->parallelFor(m_tapers->count(), [&](size_t chunk, size_t begin, size_t end) {
+            Worker& worker = m_workers[chunk];
+            for (size_t k = begin; k < end; k++) {
+                const T* taper = m_tapers->taper(k);
+                for (size_t i = 0; i < n; i++) {
+                    worker.frame[i] = signal[i] * taper[i];
+                }
+                worker.fft.forward(worker.frame.data(), worker.spectrum.data());
+                T* spectrum = m_eigenspectra.data() + k * m_bins;
+                for (size_t bin = 0; bin < m_bins; bin++) {
+                    spectrum[bin] = std::norm(worker.spectrum[bin]);
+                }
+            }
+        });
+
+        T variance = static_cast<T>(0.0);
+        for (size_t i = 0; i < n; i++) {
+            variance += signal[i] * signal[i];
+        }
+        variance /= static_cast<T>(n);
+        m_pool->parallelFor(m_bins, [&](size_t, size_t begin, size_t end) { combine(begin, end, variance); });
+
+        const T scale = static_cast<T>(1.0) / m_sampleRate;
+        for (size_t bin = 0; bin < m_bins; bin++) {
+            m_psd[bin] *= (bin == 0 || bin == m_bins - 1) ? scale : 2 * scale;
+        }
+    }
+
+    /**
+     * \brief Gets the density of one bin of the last estimate.
+     *
+     * \param bin Frequency bin (frequency = bin * sampleRate / fftSize()).
+     *
+     * \return One-sided power spectral density in units^2/Hz.
+     *
+     * \throws std::out_of_range if bin >= bins().
+     */
+    T psd(size_t bin) const {
+        if (bin >= m_bins) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        return m_psd[bin];
+    }
+
+    /// @brief Gets the last estimate
+    /// @return Densities of all bins
+    std::vector<T> psd() const { return std::vector<T>(m_psd.data(), m_psd.data() + m_bins); }
+
+    /// @brief Gets the effective degrees of freedom of the last estimate
+    /// @return 2 * (sum d_k^2)^2 / sum d_k^4 per bin (2K without adaptive weighting)
+    std::vector<T> degreesOfFreedom() const { return std::vector<T>(m_dof.data(), m_dof.data() + m_bins); }
+
+    /// @brief Gets frequency of a bin
+    /// @param bin Frequency bin
+    /// @return Frequency in Hz
+    T frequency(size_t bin) const { return static_cast<T>(bin) * m_sampleRate / static_cast<T>(m_fftSize); }
+
+    /// @brief Enables or disables adaptive weighting (applies to the next compute())
+    /// @param adaptive true for Thomson's adaptive weights, false for equal weights
+    void setAdaptive(bool adaptive) { m_adaptive = adaptive; }
+
+    /// @brief Checks if adaptive weighting is enabled
+    /// @return true if enabled
+    bool isAdaptive() const { return m_adaptive; }
+
+    /// @brief Gets the tapers
+    /// @return Shared taper set
+    const Dpss<T>& tapers() const { return *m_tapers; }
+
+    /// @brief Gets record length
+    /// @return N
+    size_t length() const { return m_tapers->length(); }
+
+    /// @brief Gets number of tapers
+    /// @return K
+    size_t numTapers() const { return m_tapers->count(); }
+
+    /// @brief Gets FFT size
+    /// @return Transform length
+    size_t fftSize() const { return m_fftSize; }
+
+    /// @brief Gets number of bins
+    /// @return fftSize()/2+1
+    size_t bins() const { return m_bins; }
+};
+}  // namespace md
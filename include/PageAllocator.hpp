@@ -0,0 +1,258 @@
+#pragma once
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace md {
+/// @brief Kind of pages backing large allocations
+enum class PageMode {
+    /// @brief Regular pages from the heap allocator
+    Default,
+    /// @brief Anonymous mapping advised as transparent huge pages (MADV_HUGEPAGE)
+    Transparent,
+    /// @brief Reserved huge pages (MAP_HUGETLB), falling back to Transparent when none are available
+    Explicit
+};
+
+/**
+ * \brief How large buffers obtain their memory.
+ *
+ * Allocations of at least threshold bytes are mapped on 2 MiB boundaries in
+ * the requested page mode; smaller ones always come from the heap. With
+ * prefault set, all pages are populated when the buffer is allocated, so the
+ * first pass over a fresh signal does not stall on page faults. With lock
+ * set, the pages are additionally locked in RAM (best effort, subject to
+ * RLIMIT_MEMLOCK). Mapping, prefaulting and locking need Linux; elsewhere
+ * every policy behaves like the default one.
+ */
+struct MemoryPolicy {
+    /// @brief Page mode of large allocations
+    PageMode pages = PageMode::Default;
+    /// @brief Populate all pages at allocation time
+    bool prefault = false;
+    /// @brief Lock pages in RAM (mlock)
+    bool lock = false;
+    /// @brief Minimum size (bytes) of allocations that follow the policy
+    size_t threshold = size_t(2) << 20;
+
+    /// @brief Equality comparison operator
+    /// @param other Policy to compare with
+    /// @return true if both policies allocate the same way
+    bool operator==(const MemoryPolicy& other) const {
+        return pages == other.pages && prefault == other.prefault && lock == other.lock &&
+               threshold == other.threshold;
+    }
+
+    /// @brief Inequality comparison operator
+    /// @param other Policy to compare with
+    /// @return true if the policies differ
+    bool operator!=(const MemoryPolicy& other) const { return !(*this == other); }
+};
+
+namespace detail {
+/// @brief Size and alignment of huge pages
+constexpr size_t kHugePageSize = size_t(2) << 20;
+
+/// @brief Checks whether an allocation bypasses the heap
+inline bool isMapped(size_t bytes, const MemoryPolicy& policy) {
+#ifdef __linux__
+    return bytes >= policy.threshold && (policy.pages != PageMode::Default || policy.prefault || policy.lock);
+#else
+    (void)bytes;
+    (void)policy;
+    return false;
+#endif
+}
+
+/// @brief Rounds a mapped allocation up to whole huge pages
+inline size_t mappedBytes(size_t bytes) { return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize; }
+
+#ifdef __linux__
+/// @brief Maps anonymous memory on a huge page boundary (nullptr on failure)
+inline void* mapAligned(size_t size, int flags) {
+    size_t reserved = size + kHugePageSize;
+    void* mapping = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(mapping);
+    uintptr_t aligned = (start + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > start) {
+        ::munmap(mapping, aligned - start);
+    }
+    size_t tail = reserved - (aligned - start) - size;
+    if (tail > 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+/// @brief Writes one byte per page so every page is faulted in now
+inline void touchPages(void* data, size_t size) {
+    volatile uint8_t* bytes = static_cast<uint8_t*>(data);
+    for (size_t offset = 0; offset < size; offset += 4096) {
+        bytes[offset] = 0;
+    }
+}
+#endif
+}  // namespace detail
+
+/**
+ * \brief Allocates memory according to a policy.
+ *
+ * \param bytes Number of bytes.
+ * \param alignment Alignment of heap allocations (mapped memory is 2 MiB aligned).
+ * \param policy Allocation policy.
+ *
+ * \return Uninitialized memory (mapped memory is zeroed), freed with deallocatePages().
+ *
+ * \throws std::bad_alloc if no memory is available.
+ */
+inline void* allocatePages(size_t bytes, size_t alignment, const MemoryPolicy& policy) {
+#ifdef __linux__
+    if (detail::isMapped(bytes, policy)) {
+        size_t size = detail::mappedBytes(bytes);
+        void* data = nullptr;
+#ifdef MAP_HUGETLB
+        if (policy.pages == PageMode::Explicit) {
+            // Reserved huge pages are aligned by the kernel
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (policy.prefault ? MAP_POPULATE : 0);
+            data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+            data = data == MAP_FAILED ? nullptr : data;
+        }
+#endif
+        if (data == nullptr) {
+            bool transparent = policy.pages != PageMode::Default;
+            // Transparent huge pages must be advised before the pages are populated
+            data = detail::mapAligned(size, policy.prefault && !transparent ? MAP_POPULATE : 0);
+            if (data == nullptr) {
+                throw std::bad_alloc();
+            }
+#ifdef MADV_HUGEPAGE
+            if (transparent) {
+                ::madvise(data, size, MADV_HUGEPAGE);
+            }
+#endif
+            if (policy.prefault && transparent) {
+#ifdef MADV_POPULATE_WRITE
+                if (::madvise(data, size, MADV_POPULATE_WRITE) != 0) {
+                    detail::touchPages(data, size);
+                }
+#else
+                detail::touchPages(data, size);
+#endif
+            }
+        }
+        if (policy.lock) {
+            ::mlock(data, size);
+        }
+        return data;
+    }
+#endif
+    return ::operator new(bytes, std::align_val_t(alignment));
+}
+
+/**
+ * \brief Frees memory obtained from allocatePages().
+ *
+ * \param data Pointer returned by allocatePages().
+ * \param bytes Size passed to allocatePages().
+ * \param alignment Alignment passed to allocatePages().
+ * \param policy Policy passed to allocatePages().
+ */
+inline void deallocatePages(void* data, size_t bytes, size_t alignment, const MemoryPolicy& policy) {
+    if (data == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    if (detail::isMapped(bytes, policy)) {
+        // munmap also drops any mlock
+        ::munmap(data, detail::mappedBytes(bytes));
+        return;
+    }
+#endif
+    ::operator delete(data, std::align_val_t(alignment));
+}
+
+/**
+ * \brief Standard allocator that follows a MemoryPolicy.
+ *
+ * Lets standard containers hold large signals in huge, prefaulted pages:
+ * \code
+ * MemoryPolicy policy{PageMode::Transparent, true};
+ * std::vector<double, PageAllocator<double>> samples(length, PageAllocator<double>(policy));
+ * \endcode
+ * Containers should be sized once; every reallocation maps fresh memory.
+ *
+ * \tparam T Element type.
+ */
+template <typename T>
+class PageAllocator {
+    template <typename U>
+    friend class PageAllocator;
+
+   private:
+    /// \brief Allocation policy
+    MemoryPolicy m_policy;
+
+   public:
+    using value_type = T;
+
+    /**
+     * \brief Creates an allocator.
+     *
+     * \param policy Allocation policy.
+     */
+    explicit PageAllocator(const MemoryPolicy& policy = MemoryPolicy()) : m_policy(policy) {}
+
+    /// @brief Converts from an allocator of another type (used by containers)
+    /// @param other Allocator to copy the policy from
+    template <typename U>
+    PageAllocator(const PageAllocator<U>& other) : m_policy(other.m_policy) {}
+
+    /**
+     * \brief Allocates an uninitialized array.
+     *
+     * \param count Number of elements.
+     *
+     * \return Pointer to count elements.
+     *
+     * \throws std::bad_alloc if no memory is available.
+     */
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(allocatePages(count * sizeof(T), alignof(T), m_policy));
+    }
+
+    /// @brief Frees an array
+    /// @param data Pointer returned by allocate()
+    /// @param count Number of elements passed to allocate()
+    void deallocate(T* data, size_t count) { deallocatePages(data, count * sizeof(T), alignof(T), m_policy); }
+
+    /// @brief Gets allocation policy
+    /// @return Policy
+    const MemoryPolicy& policy() const { return m_policy; }
+
+    /// @brief Equality comparison operator (equal allocators can free each other's memory)
+    /// @param other Allocator to compare with
+    /// @return true if the policies are equal
+    template <typename U>
+    bool operator==(const PageAllocator<U>& other) const {
+        return m_policy == other.m_policy;
+    }
+
+    /// @brief Inequality comparison operator
+    /// @param other Allocator to compare with
+    /// @return true if the policies differ
+    template <typename U>
+    bool operator!=(const PageAllocator<U>& other) const {
+        return !(*this == other);
+    }
+};
+}  // namespace md
@@ -0,0 +1,509 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "Filter.hpp"
+#include "SignalProcessor.hpp"
+
+namespace md {
+namespace detail {
+/// @brief Rotates a 64-bit value left
+inline uint64_t rotateLeft(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+/// @brief Reads an unaligned 64-bit word
+inline uint64_t readWord(const unsigned char* data) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+/**
+ * \brief Computes the 64-bit XXH64 hash of a byte range.
+ *
+ * Processes 32 bytes per iteration in four independent lanes, which runs at
+ * memory bandwidth for large inputs. Not a cryptographic hash.
+ *
+ * \param data Bytes to hash.
+ * \param length Number of bytes.
+ * \param seed Seed (chains several hashes when set to a previous result).
+ *
+ * \return Hash value.
+ */
+inline uint64_t hash64(const void* data, size_t length, uint64_t seed = 0) {
+    constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+    constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+    constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+    constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+    constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+    auto round = [](uint64_t acc, uint64_t input) { return rotateLeft(acc + input * kPrime2, 31) * kPrime1; };
+    auto merge = [&round](uint64_t acc, uint64_t value) { return (acc ^ round(0, value)) * kPrime1 + kPrime4; };
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    uint64_t h;
+    if (length >= 32) {
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round(v1, readWord(p));
+            v2 = round(v2, readWord(p + 8));
+            v3 = round(v3, readWord(p + 16));
+            v4 = round(v4, readWord(p + 24));
+        }
+        h = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        h = merge(h, v1);
+        h = merge(h, v2);
+        h = merge(h, v3);
+        h = merge(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+    h += static_cast<uint64_t>(length);
+    for (; p + 8 <= end; p += 8) {
+        h = rotateLeft(h ^ round(0, readWord(p)), 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+        uint32_t word;
+        std::memcpy(&word, p, sizeof(word));
+        h = rotateLeft(h ^ (static_cast<uint64_t>(word) * kPrime1), 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h = rotateLeft(h ^ (static_cast<uint64_t>(*p) * kPrime5), 11) * kPrime1;
+    }
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * \brief Read-only memory mapping of a whole file.
+ *
+ * Move-only owner of the mapping; the file descriptor is closed right after
+ * mapping.
+ */
+class FileMapping {
+   private:
+    /// \brief Mapped bytes (nullptr for an empty or failed mapping)
+    void* m_data = nullptr;
+    /// \brief Number of mapped bytes
+    size_t m_size = 0;
+
+   public:
+    /// @brief Creates an empty mapping
+    FileMapping() = default;
+
+    /**
+     * \brief Maps a file.
+     *
+     * \param path File to map.
+     *
+     * \return true if the file was opened (an empty file maps to no data).
+     */
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        if (size > 0) {
+            void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                return false;
+            }
+            m_data = data;
+            m_size = size;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    /// @brief Unmaps the file
+    void close() {
+        if (m_data != nullptr) {
+            ::munmap(m_data, m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    /// @brief Move constructor
+    /// @param other Mapping to take over
+    FileMapping(FileMapping&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+    /// @brief Move assignment operator
+    /// @param other Mapping to take over
+    /// @return Reference to this mapping
+    FileMapping& operator=(FileMapping&& other) noexcept {
+        if (this != &other) {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    /// @brief Unmaps the file
+    ~FileMapping() { close(); }
+
+    /// @brief Gets mapped bytes
+    /// @return Pointer to the file contents
+    const unsigned char* data() const { return static_cast<const unsigned char*>(m_data); }
+
+    /// @brief Gets number of mapped bytes
+    /// @return File size
+    size_t size() const { return m_size; }
+};
+}  // namespace detail
+
+/**
+ * \brief Key of a cached result.
+ *
+ * Accumulates a 64-bit hash over everything the result depends on: input
+ * file contents, and the configuration of every processor of the chain in
+ * processing order. A processor contributes its dynamic type (which includes
+ * all template arguments, e.g. NumB and NumA of an IirFilter), Size,
+ * sizeof(T) and the exact bytes of its factors. A Filter also contributes its
+ * gating configuration and its current state, so a filter that has already
+ * processed data or skips quiet blocks gets a different key than a freshly
+ * reset, ungated one.
+ */
+class ResultKey {
+   private:
+    /// \brief Hash of everything added so far
+    uint64_t m_hash = 0;
+
+   public:
+    /**
+     * \brief Adds raw bytes.
+     *
+     * \param data Bytes to add.
+     * \param length Number of bytes.
+     *
+     * \return Reference to this key.
+     */
+    ResultKey& addBytes(const void* data, size_t length) {
+        m_hash = detail::hash64(data, length, m_hash);
+        return *this;
+    }
+
+    /**
+     * \brief Adds a trivially copyable value (e.g. a sample rate or a parameter).
+     *
+     * \param value Value to add.
+     *
+     * \return Reference to this key.
+     */
+    template <typename V>
+    ResultKey& addValue(const V& value) {
+        static_assert(std::is_trivially_copyable<V>::value, "Value must be trivially copyable!");
+        return addBytes(&value, sizeof(V));
+    }
+
+    /**
+     * \brief Adds the contents of a file.
+     *
+     * The file is memory-mapped and hashed in one pass.
+     *
+     * \param path File to add.
+     *
+     * \return Reference to this key.
+     *
+     * \throws std::invalid_argument if the file cannot be opened.
+     */
+    ResultKey& addFile(std::string_view path) {
+        detail::FileMapping mapping;
+        if (!mapping.open(std::string(path))) {
+            throw std::invalid_argument("File can not be open!");
+        }
+        addValue(mapping.size());
+        return addBytes(mapping.data(), mapping.size());
+    }
+
+    /**
+     * \brief Adds the configuration of a processor.
+     *
+     * \param processor Processor (filter, window, ...) of the chain.
+     *
+     * \return Reference to this key.
+     */
+    template <typename T, size_t Size>
+    ResultKey& addProcessor(const SignalProcessor<T, Size>& processor) {
+        const char* type = typeid(processor).name();
+        addBytes(type, std::strlen(type));
+        addValue(Size);
+        addValue(sizeof(T));
+        std::array<T, Size> factors = processor.getFactors();
+        addBytes(factors.data(), sizeof(T) * Size);
+        if (auto* filter = dynamic_cast<const Filter<T, Size>*>(&processor)) {
+            bool gated = filter->isGateEnabled();
+            addValue(gated);
+            if (gated) {
+                addValue(filter->getGateThreshold());
+                addValue(filter->getGateEpsilon());
+            }
+            std::vector<T> state = filter->getStateValues();
+            addValue(state.size());
+            addBytes(state.data(), sizeof(T) * state.size());
+        }
+        return *this;
+    }
+
+    /// @brief Gets the key value
+    /// @return 64-bit hash
+    uint64_t value() const { return m_hash; }
+};
+
+/**
+ * \brief Memory-mapped result loaded from a ResultCache.
+ *
+ * \tparam T Sample type.
+ */
+template <typename T>
+class CachedResult {
+   private:
+    /// \brief Mapping of the cache file
+    detail::FileMapping m_mapping;
+    /// \brief First sample inside the mapping
+    const T* m_data = nullptr;
+    /// \brief Number of samples
+    size_t m_size = 0;
+
+   public:
+    /// @brief Creates an empty (invalid) result
+    CachedResult() = default;
+
+    /**
+     * \brief Takes over a validated mapping.
+     *
+     * \param mapping Mapping of the cache file.
+     * \param offset Byte offset of the first sample.
+     * \param size Number of samples.
+     */
+    CachedResult(detail::FileMapping&& mapping, size_t offset, size_t size)
+        : m_mapping(std::move(mapping)), m_size(size) {
+        m_data = size > 0 ? reinterpret_cast<const T*>(m_mapping.data() + offset) : nullptr;
+    }
+
+    /// @brief Checks if the result was found
+    /// @return true if data() is valid
+    bool valid() const { return m_data != nullptr || m_mapping.data() != nullptr; }
+
+    /// @brief Gets the samples
+    /// @return Pointer to size() samples (read-only, mapped from disk)
+    const T* data() const { return m_data; }
+
+    /// @brief Gets number of samples
+    /// @return Number of samples
+    size_t size() const { return m_size; }
+
+    /// @brief Gets a sample
+    /// @param index Sample index (unchecked)
+    /// @return Sample value
+    const T& operator[](size_t index) const { return m_data[index]; }
+
+    /// @brief Gets iterator to the first sample
+    /// @return Pointer to the first sample
+    const T* begin() const { return m_data; }
+
+    /// @brief Gets iterator past the last sample
+    /// @return Pointer past the last sample
+    const T* end() const { return m_data + m_size; }
+};
+
+/**
+ * \brief On-disk cache of processing results.
+ *
+ * Stores sample arrays in a directory, one file per ResultKey. Reruns of a
+ * job with identical input and chain configuration find the result and
+ * memory-map it instead of filtering again. Files are written to a temporary
+ * name and renamed, so concurrent jobs never see partial results. Each file
+ * starts with a small header (magic, sample size, count, key) which is
+ * checked when loading; mismatching or truncated files are treated as
+ * missing.
+ */
+class ResultCache {
+   private:
+    /// \brief Header of a cache file (padded to keep samples 64-byte aligned)
+    struct Header {
+        /// @brief File format identifier
+        char magic[8];
+        /// @brief Key the result was stored under
+        uint64_t key;
+        /// @brief sizeof(T) of the samples
+        uint64_t sampleSize;
+        /// @brief Number of samples
+        uint64_t count;
+        /// @brief Padding up to the first sample
+        unsigned char reserved[32];
+    };
+    static_assert(sizeof(Header) == 64, "Cache header must be 64 bytes!");
+
+    /// \brief Cache file format identifier
+    static constexpr char kMagic[8] = {'M', 'D', 'R', 'C', 'A', 'C', 'H', '1'};
+
+    /// \brief Cache directory
+    std::filesystem::path m_directory;
+
+    /**
+     * \brief Gets the file of a key.
+     *
+     * \param key Result key.
+     *
+     * \return Path of the cache file.
+     */
+    std::filesystem::path pathOf(uint64_t key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return m_directory / name;
+    }
+
+   public:
+    /**
+     * \brief Opens (and creates if needed) a cache directory.
+     *
+     * \param directory Cache directory.
+     *
+     * \throws std::invalid_argument if the directory cannot be created.
+     */
+    explicit ResultCache(std::string_view directory) : m_directory(directory) {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        if (error || !std::filesystem::is_directory(m_directory)) {
+            throw std::invalid_argument("Cache directory can not be created!");
+        }
+    }
+
+    /**
+     * \brief Loads a stored result.
+     *
+     * \param key Result key.
+     *
+     * \return Mapped result, invalid if not stored (or stored with another sample type).
+     */
+    template <typename T>
+    CachedResult<T> load(const ResultKey& key) const {
+        detail::FileMapping mapping;
+        if (!mapping.open(pathOf(key.value()).string()) || mapping.size() < sizeof(Header)) {
+            return CachedResult<T>();
+        }
+        Header header;
+        std::memcpy(&header, mapping.data(), sizeof(Header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.key != key.value() ||
+            header.sampleSize != sizeof(T) || header.count > (mapping.size() - sizeof(Header)) / sizeof(T) ||
+            mapping.size() != sizeof(Header) + header.count * sizeof(T)) {
+            return CachedResult<T>();
+        }
+        return CachedResult<T>(std::move(mapping), sizeof(Header), static_cast<size_t>(header.count));
+    }
+
+    /**
+     * \brief Stores a result.
+     *
+     * \param key Result key.
+     * \param data Samples to store.
+     * \param count Number of samples.
+     *
+     * \throws std::runtime_error if the file cannot be written.
+     */
+    template <typename T>
+    void store(const ResultKey& key, const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Sample type must be trivially copyable!");
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.key = key.value();
+        header.sampleSize = sizeof(T);
+        header.count = count;
+
+        std::filesystem::path target = pathOf(key.value());
+        std::filesystem::path temporary = target;
+        temporary += ".tmp" + std::to_string(::getpid());
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (file == nullptr) {
+            throw std::runtime_error("Failed to write cache file");
+        }
+        bool written = std::fwrite(&header, sizeof(Header), 1, file) == 1 &&
+                       (count == 0 || std::fwrite(data, sizeof(T), count, file) == count);
+        written = std::fclose(file) == 0 && written;
+        std::error_code error;
+        if (written) {
+            std::filesystem::rename(temporary, target, error);
+        }
+        if (!written || error) {
+            std::filesystem::remove(temporary, error);
+            throw std::runtime_error("Failed to write cache file");
+        }
+    }
+
+    /**
+     * \brief Loads a result or computes and stores it.
+     *
+     * \param key Result key.
+     * \param compute Callable returning the result as std::vector<T> (called on a miss only).
+     *
+     * \return Mapped result.
+     *
+     * \throws std::runtime_error if the result cannot be stored.
+     */
+    template <typename T, typename Compute>
+    CachedResult<T> getOrCompute(const ResultKey& key, Compute&& compute) {
+        CachedResult<T> result = load<T>(key);
+        if (result.valid()) {
+            return result;
+        }
+        std::vector<T> computed = compute();
+        store(key, computed.data(), computed.size());
+        return load<T>(key);
+    }
+
+    /**
+     * \brief Checks if a result is stored.
+     *
+     * \param key Result key.
+     *
+     * \return true if a cache file exists for the key.
+     */
+    bool contains(const ResultKey& key) const { return std::filesystem::exists(pathOf(key.value())); }
+
+    /**
+     * \brief Removes a stored result.
+     *
+     * \param key Result key.
+     */
+    void remove(const ResultKey& key) {
+        std::error_code error;
+        std::filesystem::remove(pathOf(key.value()), error);
+    }
+};
+}  // namespace md
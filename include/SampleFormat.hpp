@@ -0,0 +1,486 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "AlignedBuffer.hpp"
+
+namespace md {
+/**
+ * \brief Integer sample formats (little-endian, as in WAV files).
+ */
+enum class SampleFormat {
+    /// @brief 16-bit signed, 2 bytes per sample
+    Int16,
+    /// @brief 24-bit signed, packed into 3 bytes per sample
+    Int24,
+    /// @brief 32-bit signed, 4 bytes per sample
+    Int32
+};
+
+/**
+ * \brief Dither added before quantization.
+ */
+enum class Dither {
+    /// @brief Plain rounding
+    None,
+    /// @brief Triangular PDF dither of +-1 LSB peak
+    Triangular
+};
+
+/**
+ * \brief Spectral shaping of the quantization error.
+ */
+enum class NoiseShaping {
+    /// @brief White quantization error
+    None,
+    /// @brief Error filtered by (1 - z^-1), pushed towards high frequencies
+    FirstOrder,
+    /// @brief Error filtered by (1 - z^-1)^2
+    SecondOrder
+};
+
+/**
+ * \brief Gets the bytes per sample of a format.
+ *
+ * \param format Sample format.
+ *
+ * \return 2, 3 or 4.
+ */
+constexpr size_t sampleBytes(SampleFormat format) {
+    return format == SampleFormat::Int16 ? 2 : (format == SampleFormat::Int24 ? 3 : 4);
+}
+
+/**
+ * \brief Gets the bits per sample of a format.
+ *
+ * \param format Sample format.
+ *
+ * \return 16, 24 or 32.
+ */
+constexpr int sampleBits(SampleFormat format) { return static_cast<int>(sampleBytes(format)) * 8; }
+
+namespace detail {
+// Little-endian hosts can copy 16- and 32-bit samples without reordering bytes
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool kLittleEndian = false;
+#else
+constexpr bool kLittleEndian = true;
+#endif
+
+/**
+ * \brief Loads integer sample i of a byte stream.
+ *
+ * \tparam Format Sample format.
+ * \param bytes Sample bytes.
+ * \param i Sample index.
+ *
+ * \return Sign-extended sample.
+ */
+template <SampleFormat Format>
+inline int32_t loadSample(const uint8_t* bytes, size_t i) {
+    if constexpr (Format == SampleFormat::Int16) {
+        const uint8_t* p = bytes + 2 * i;
+        return static_cast<int16_t>(static_cast<uint16_t>(p[0] | (p[1] << 8)));
+    } else if constexpr (Format == SampleFormat::Int24) {
+        const uint8_t* p = bytes + 3 * i;
+        uint32_t value = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                         (static_cast<uint32_t>(p[2]) << 16);
+        return static_cast<int32_t>(value << 8) >> 8;
+    } else {
+        const uint8_t* p = bytes + 4 * i;
+        return static_cast<int32_t>(static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                                    (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24));
+    }
+}
+
+/**
+ * \brief Stores integer sample i into a byte stream.
+ *
+ * \tparam Format Sample format.
+ * \param bytes Sample bytes.
+ * \param i Sample index.
+ * \param value Sample (already within the range of the format).
+ */
+template <SampleFormat Format>
+inline void storeSample(uint8_t* bytes, size_t i, int32_t value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    uint8_t* p = bytes + sampleBytes(Format) * i;
+    p[0] = static_cast<uint8_t>(bits);
+    p[1] = static_cast<uint8_t>(bits >> 8);
+    if constexpr (Format != SampleFormat::Int16) {
+        p[2] = static_cast<uint8_t>(bits >> 16);
+    }
+    if constexpr (Format == SampleFormat::Int32) {
+        p[3] = static_cast<uint8_t>(bits >> 24);
+    }
+}
+
+/**
+ * \brief Stores a block of integer samples into a byte stream.
+ *
+ * On little-endian hosts 16- and 32-bit samples are narrowed and copied as a
+ * whole, so the loops vectorize; 24-bit samples are packed byte by byte.
+ *
+ * \tparam Format Sample format.
+ * \param bytes Sample bytes.
+ * \param values Samples (already within the range of the format).
+ * \param count Number of samples (<= Count).
+ */
+template <SampleFormat Format, size_t Count>
+inline void storeSamples(uint8_t* bytes, const int32_t (&values)[Count], size_t count) {
+    if constexpr (kLittleEndian && Format == SampleFormat::Int32) {
+        std::memcpy(bytes, values, count * sizeof(int32_t));
+    } else if constexpr (kLittleEndian && Format == SampleFormat::Int16) {
+        int16_t narrow[Count];
+        for (size_t i = 0; i < count; i++) {
+            narrow[i] = static_cast<int16_t>(values[i]);
+        }
+        std::memcpy(bytes, narrow, count * sizeof(int16_t));
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            storeSample<Format>(bytes, i, values[i]);
+        }
+    }
+}
+
+/**
+ * \brief Hashes a counter into 32 well-mixed random bits (lowbias32).
+ *
+ * Stateless, so every sample's dither is computed independently and the
+ * quantization loop stays vectorizable.
+ *
+ * \param x Counter value.
+ *
+ * \return Random bits.
+ */
+inline uint32_t hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+}  // namespace detail
+
+/**
+ * \brief Converts integer samples into floating-point samples.
+ *
+ * Full scale maps to 1.0: an N-bit sample s becomes s / 2^(N-1) times the
+ * gain. The loops are branch-free per sample and vectorized by the compiler.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class SampleDecoder {
+   private:
+    /// \brief Input sample format
+    SampleFormat m_format;
+    /// \brief Factor from integer to floating-point value
+    T m_scale;
+
+    /// @brief Decoding loop for one format
+    template <SampleFormat Format>
+    void run(const uint8_t* input, T* output, size_t count) const {
+        const T scale = m_scale;
+        for (size_t i = 0; i < count; i++) {
+            output[i] = static_cast<T>(detail::loadSample<Format>(input, i)) * scale;
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates a decoder.
+     *
+     * \param format Input sample format.
+     * \param gain Gain applied while converting.
+     */
+    explicit SampleDecoder(SampleFormat format, T gain = static_cast<T>(1.0))
+        : m_format(format), m_scale(gain / std::ldexp(static_cast<T>(1.0), sampleBits(format) - 1)) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+    }
+
+    /**
+     * \brief Converts samples.
+     *
+     * \param input Integer samples (count * sampleBytes(format()) bytes).
+     * \param output Output samples.
+     * \param count Number of samples.
+     *
+     * \throws std::invalid_argument if input or output is nullptr.
+     */
+    void decode(const void* input, T* output, size_t count) const {
+        if (input == nullptr || output == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(input);
+        switch (m_format) {
+            case SampleFormat::Int16:
+                run<SampleFormat::Int16>(bytes, output, count);
+                break;
+            case SampleFormat::Int24:
+                run<SampleFormat::Int24>(bytes, output, count);
+                break;
+            case SampleFormat::Int32:
+                run<SampleFormat::Int32>(bytes, output, count);
+                break;
+        }
+    }
+
+    /// @brief Gets the input format
+    /// @return Sample format
+    SampleFormat format() const { return m_format; }
+};
+
+/**
+ * \brief Converts floating-point samples into integer samples.
+ *
+ * Values are scaled so that 1.0 is full scale, optionally dithered and noise
+ * shaped, rounded to the nearest integer and saturated to the range of the
+ * format. NaN samples are encoded as 0. Without noise shaping every sample is
+ * independent (the triangular dither comes from a hash of a running counter),
+ * so blocks of samples are quantized into 32-bit integers by a loop that GCC
+ * vectorizes at -O3 (double needs SSE4.2 on x86 for 64-bit comparisons). On
+ * little-endian hosts 16- and 32-bit blocks are then stored with vectorized
+ * copies, 24-bit samples are packed byte by byte.
+ * Noise shaping feeds the quantization error of previous samples back and is
+ * evaluated sample by sample; its state carries over between encode() calls.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class SampleEncoder {
+   private:
+    /// @brief Number of samples quantized into a block before they are stored
+    static constexpr size_t kBlock = 256;
+
+    /// \brief Output sample format
+    SampleFormat m_format;
+    /// \brief Factor from floating-point to integer value
+    T m_scale;
+    /// \brief Dither type
+    Dither m_dither;
+    /// \brief Noise shaping type
+    NoiseShaping m_shaping;
+    /// \brief Dither seed
+    uint32_t m_seed;
+    /// \brief Index of the next sample, drives the dither
+    uint32_t m_counter = 0;
+    /// \brief Quantization error of the previous sample
+    T m_error1 = 0;
+    /// \brief Quantization error of the sample before the previous one
+    T m_error2 = 0;
+
+    /**
+     * \brief Gets triangular dither for a sample.
+     *
+     * \param index Sample counter.
+     *
+     * \return Dither in (-1, 1) LSB.
+     */
+    T dither(uint32_t index) const {
+        uint32_t bits = detail::hash32(index * 0x9e3779b9U ^ m_seed);
+        return (static_cast<T>(bits & 0xffffU) - static_cast<T>(bits >> 16)) * static_cast<T>(1.0 / 65536.0);
+    }
+
+    /// @brief Encoding loop for one format, without noise shaping
+    template <SampleFormat Format>
+    size_t runPlain(const T* input, uint8_t* output, size_t count) {
+        const T scale = m_scale;
+        const T low = -std::ldexp(static_cast<T>(1.0), sampleBits(Format) - 1);
+        const T high = std::min(-low - 1, std::nextafter(-low, static_cast<T>(0.0)));
+        const T amount = m_dither == Dither::Triangular ? static_cast<T>(1.0) : static_cast<T>(0.0);
+        const uint32_t start = m_counter;
+        size_t clipped = 0;
+        int32_t block[kBlock];
+        for (size_t pos = 0; pos < count; pos += kBlock) {
+            const size_t length = std::min(kBlock, count - pos);
+            const T* in = input + pos;
+            for (size_t i = 0; i < length; i++) {
+                // NaN encodes as 0 (converting it to an integer is undefined)
+                T x = in[i] == in[i] ? in[i] : static_cast<T>(0.0);
+                T v = x * scale + amount * dither(start + static_cast<uint32_t>(pos + i));
+                clipped += (v > high) | (v < low);
+                // Rounding with the sign of v (the range contains 0, so the sign survives clamping):
+                // rounding the clamped value instead makes GCC branch on the constant bounds
+                T q = std::min(std::max(v, low), high) + std::copysign(static_cast<T>(0.5), v);
+                block[i] = static_cast<int32_t>(q);
+            }
+            detail::storeSamples<Format>(output + sampleBytes(Format) * pos, block, length);
+        }
+        m_counter = start + static_cast<uint32_t>(count);
+        return clipped;
+    }
+
+    /// @brief Encoding loop for one format, with noise shaping
+    template <SampleFormat Format>
+    size_t runShaped(const T* input, uint8_t* output, size_t count) {
+        const T scale = m_scale;
+        const T low = -std::ldexp(static_cast<T>(1.0), sampleBits(Format) - 1);
+        const T high = std::min(-low - 1, std::nextafter(-low, static_cast<T>(0.0)));
+        const T amount = m_dither == Dither::Triangular ? static_cast<T>(1.0) : static_cast<T>(0.0);
+        // Error filter h such that the output error is (1 - sum h_k z^-k) e
+        const T h1 = m_shaping == NoiseShaping::FirstOrder ? static_cast<T>(1.0) : static_cast<T>(2.0);
+        const T h2 = m_shaping == NoiseShaping::FirstOrder ? static_cast<T>(0.0) : static_cast<T>(-1.0);
+        size_t clipped = 0;
+        for (size_t i = 0; i < count; i++) {
+            // NaN encodes as 0 (converting it to an integer is undefined)
+            T x = input[i] == input[i] ? input[i] : static_cast<T>(0.0);
+            T v = x * scale - h1 * m_error1 - h2 * m_error2;
+            T d = v + amount * dither(m_counter++);
+            T q = std::floor(d + static_cast<T>(0.5));
+            // The error is taken before saturation so clipping cannot make the loop unstable;
+            // an infinite input leaves no defined error and must not turn the state into NaN
+            T error = q - v;
+            m_error2 = m_error1;
+            m_error1 = error == error ? error : static_cast<T>(0.0);
+            clipped += (q > high) | (q < low);
+            detail::storeSample<Format>(output, i, static_cast<int32_t>(std::min(std::max(q, low), high)));
+        }
+        return clipped;
+    }
+
+    /// @brief Dispatches to the loop of one format
+    template <SampleFormat Format>
+    size_t run(const T* input, uint8_t* output, size_t count) {
+        return m_shaping == NoiseShaping::None ? runPlain<Format>(input, output, count)
+                                               : runShaped<Format>(input, output, count);
+    }
+
+   public:
+    /**
+     * \brief Creates an encoder.
+     *
+     * \param format Output sample format.
+     * \param dither Dither added before rounding.
+     * \param shaping Noise shaping of the quantization error.
+     * \param gain Gain applied while converting.
+     * \param seed Dither seed.
+     */
+    explicit SampleEncoder(SampleFormat format, Dither dither = Dither::None, NoiseShaping shaping = NoiseShaping::None,
+                           T gain = static_cast<T>(1.0), uint32_t seed = 0x12345678U)
+        : m_format(format),
+          m_scale(gain * std::ldexp(static_cast<T>(1.0), sampleBits(format) - 1)),
+          m_dither(dither),
+          m_shaping(shaping),
+          m_seed(seed) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+    }
+
+    /**
+     * \brief Converts samples.
+     *
+     * \param input Floating-point samples.
+     * \param output Integer samples (count * sampleBytes(format()) bytes).
+     * \param count Number of samples.
+     *
+     * \return Number of samples that were saturated.
+     *
+     * \throws std::invalid_argument if input or output is nullptr.
+     */
+    size_t encode(const T* input, void* output, size_t count) {
+        if (input == nullptr || output == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        uint8_t* bytes = static_cast<uint8_t*>(output);
+        switch (m_format) {
+            case SampleFormat::Int16:
+                return run<SampleFormat::Int16>(input, bytes, count);
+            case SampleFormat::Int24:
+                return run<SampleFormat::Int24>(input, bytes, count);
+            default:
+                return run<SampleFormat::Int32>(input, bytes, count);
+        }
+    }
+
+    /// @brief Clears the noise shaping state and restarts the dither sequence
+    void reset() {
+        m_counter = 0;
+        m_error1 = 0;
+        m_error2 = 0;
+    }
+
+    /// @brief Gets the output format
+    /// @return Sample format
+    SampleFormat format() const { return m_format; }
+};
+
+/**
+ * \brief Integer in, integer out processing with conversion fused into the chain.
+ *
+ * Decodes a block of kBlock samples, runs the processor on it and encodes
+ * it, so the floating-point data only ever lives in one cache-resident block
+ * instead of being converted in a separate pass over the whole signal in
+ * each direction.
+ *
+ * \tparam T Data type (must be floating-point).
+ * \tparam Processor Type with process(T*, size_t), e.g. DynamicFilter<T>,
+ *                   FilterChain<T> or a fixed-size Filter.
+ */
+template <typename T, typename Processor>
+class FormatPipeline {
+   private:
+    /// @brief Number of samples converted and processed at a time
+    static constexpr size_t kBlock = 1024;
+
+    /// \brief Input conversion
+    SampleDecoder<T> m_decoder;
+    /// \brief Processing stage (not owned)
+    Processor& m_processor;
+    /// \brief Output conversion
+    SampleEncoder<T> m_encoder;
+    /// \brief Floating-point block
+    AlignedBuffer<T> m_block;
+
+   public:
+    /**
+     * \brief Creates a pipeline.
+     *
+     * \param decoder Input conversion.
+     * \param processor Processing stage, must outlive the pipeline.
+     * \param encoder Output conversion.
+     */
+    FormatPipeline(const SampleDecoder<T>& decoder, Processor& processor, const SampleEncoder<T>& encoder)
+        : m_decoder(decoder), m_processor(processor), m_encoder(encoder), m_block(kBlock) {}
+
+    /**
+     * \brief Processes integer samples.
+     *
+     * Input and output may be the same buffer if both formats have the same
+     * sample size.
+     *
+     * \param input Input samples in the decoder format.
+     * \param output Output samples in the encoder format.
+     * \param count Number of samples.
+     *
+     * \return Number of output samples that were saturated.
+     *
+     * \throws std::invalid_argument if input or output is nullptr or count is 0.
+     */
+    size_t process(const void* input, void* output, size_t count) {
+        if (input == nullptr || output == nullptr || count == 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        const uint8_t* in = static_cast<const uint8_t*>(input);
+        uint8_t* out = static_cast<uint8_t*>(output);
+        const size_t inBytes = sampleBytes(m_decoder.format());
+        const size_t outBytes = sampleBytes(m_encoder.format());
+        size_t clipped = 0;
+        for (size_t pos = 0; pos < count; pos += kBlock) {
+            size_t length = std::min(kBlock, count - pos);
+            m_decoder.decode(in + pos * inBytes, m_block.data(), length);
+            m_processor.process(m_block.data(), length);
+            clipped += m_encoder.encode(m_block.data(), out + pos * outBytes, length);
+        }
+        return clipped;
+    }
+
+    /// @brief Gets the output encoder (e.g. to reset its noise shaping state)
+    /// @return Encoder
+    SampleEncoder<T>& encoder() { return m_encoder; }
+};
+}  // namespace md
@@ -0,0 +1,216 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "PageAllocator.hpp"
+
+namespace md {
+/**
+ * \brief Bump-pointer allocator for short-lived temporaries.
+ *
+ * Memory is taken from large chunks by advancing an offset and handed back
+ * all at once by rewinding to a marker, usually through a ScratchScope.
+ * Chunks are kept after a rewind, so once a code path has run, running it
+ * again touches neither the heap allocator nor fresh pages. Chunks of at
+ * least kHugePage bytes use PageMode::Transparent, which keeps large FFT or
+ * design work buffers from costing one page fault and TLB entry per 4 KiB.
+ *
+ * Every thread has its own arena (local()), so temporaries need no locking.
+ * Returned memory is aligned to kBufferAlignment and uninitialized.
+ */
+class ScratchArena {
+   public:
+    /// \brief Position of the bump pointer, see mark() and rewind()
+    struct Marker {
+        /// @brief Index of the active chunk
+        size_t chunk;
+        /// @brief Offset in the active chunk
+        size_t offset;
+    };
+
+   private:
+    /// @brief Size of the first chunk
+    static constexpr size_t kMinChunk = size_t(64) << 10;
+    /// @brief Chunks of at least this size are mapped as huge pages
+    static constexpr size_t kHugePage = detail::kHugePageSize;
+
+    /// \brief Block of memory handed out piecewise
+    struct Chunk {
+        /// @brief Start of the memory
+        uint8_t* data;
+        /// @brief Size in bytes
+        size_t size;
+    };
+
+    /// \brief All chunks, in order of use
+    std::vector<Chunk> m_chunks;
+    /// \brief Index of the active chunk
+    size_t m_current = 0;
+    /// \brief Offset of the next free byte in the active chunk
+    size_t m_offset = 0;
+
+    /// @brief Allocation policy of the chunks
+    static MemoryPolicy chunkPolicy() {
+        MemoryPolicy policy;
+        policy.pages = PageMode::Transparent;
+        policy.threshold = kHugePage;
+        return policy;
+    }
+
+   public:
+    /// @brief Creates an empty arena (chunks are allocated on first use)
+    ScratchArena() = default;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /// @brief Frees all chunks
+    ~ScratchArena() { release(); }
+
+    /**
+     * \brief Gets the arena of the calling thread.
+     *
+     * \return Thread-local arena.
+     */
+    static ScratchArena& local() {
+        thread_local ScratchArena arena;
+        return arena;
+    }
+
+    /**
+     * \brief Allocates uninitialized, aligned bytes.
+     *
+     * \param bytes Number of bytes.
+     *
+     * \return Pointer aligned to kBufferAlignment, valid until rewound past.
+     *
+     * \throws std::bad_alloc if no memory is available.
+     */
+    void* allocateBytes(size_t bytes) {
+        // Rounding up to the alignment or to mapped pages must not wrap around
+        if (bytes > std::numeric_limits<size_t>::max() - kHugePage) {
+            throw std::bad_alloc();
+        }
+        bytes = (std::max<size_t>(bytes, 1) + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+        if (!m_chunks.empty() && bytes <= m_chunks[m_current].size - m_offset) {
+            void* result = m_chunks[m_current].data + m_offset;
+            m_offset += bytes;
+            return result;
+        }
+        // Reuse a later chunk that is large enough, otherwise add one (doubling up to a huge page)
+        size_t next = m_chunks.empty() ? 0 : m_current + 1;
+        while (next < m_chunks.size() && m_chunks[next].size < bytes) {
+            next++;
+        }
+        if (next == m_chunks.size()) {
+            size_t grown = m_chunks.empty() ? kMinChunk : std::min(2 * m_chunks.back().size, kHugePage);
+            size_t size = std::max(bytes, grown);
+            size = detail::isMapped(size, chunkPolicy()) ? detail::mappedBytes(size) : size;
+            void* data = allocatePages(size, kBufferAlignment, chunkPolicy());
+            m_chunks.push_back(Chunk{static_cast<uint8_t*>(data), size});
+        }
+        m_current = next;
+        m_offset = bytes;
+        return m_chunks[m_current].data;
+    }
+
+    /**
+     * \brief Allocates an uninitialized array.
+     *
+     * \tparam T Element type (must be trivially destructible, no destructor runs).
+     * \param count Number of elements.
+     *
+     * \return Pointer to count elements, valid until rewound past.
+     *
+     * \throws std::bad_alloc if no memory is available.
+     */
+    template <typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Element type must be trivially destructible!");
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(allocateBytes(count * sizeof(T)));
+    }
+
+    /// @brief Gets the current position
+    /// @return Marker to rewind to
+    Marker mark() const { return Marker{m_current, m_offset}; }
+
+    /// @brief Frees everything allocated after a marker (chunks are kept)
+    /// @param marker Position from mark()
+    void rewind(const Marker& marker) {
+        m_current = marker.chunk;
+        m_offset = marker.offset;
+    }
+
+    /// @brief Returns all chunks to the system (no allocation may be in use)
+    void release() {
+        for (const Chunk& chunk : m_chunks) {
+            deallocatePages(chunk.data, chunk.size, kBufferAlignment, chunkPolicy());
+        }
+        m_chunks.clear();
+        m_current = 0;
+        m_offset = 0;
+    }
+
+    /// @brief Gets the total size of all chunks
+    /// @return Bytes reserved by the arena
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Chunk& chunk : m_chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+};
+
+/**
+ * \brief Scope of scratch allocations.
+ *
+ * Records the arena position when created and rewinds to it when destroyed,
+ * so all temporaries allocated through the scope (or the arena meanwhile)
+ * are released together. Scopes nest like the blocks that create them.
+ */
+class ScratchScope {
+   private:
+    /// \brief Arena of the scope
+    ScratchArena& m_arena;
+    /// \brief Position to rewind to
+    ScratchArena::Marker m_marker;
+
+   public:
+    /**
+     * \brief Opens a scope.
+     *
+     * \param arena Arena to allocate from (the calling thread's by default).
+     */
+    explicit ScratchScope(ScratchArena& arena = ScratchArena::local()) : m_arena(arena), m_marker(arena.mark()) {}
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    /// @brief Releases all allocations of the scope
+    ~ScratchScope() { m_arena.rewind(m_marker); }
+
+    /**
+     * \brief Allocates an uninitialized array.
+     *
+     * \tparam T Element type (must be trivially destructible).
+     * \param count Number of elements.
+     *
+     * \return Pointer to count elements, valid until the scope ends.
+     *
+     * \throws std::bad_alloc if no memory is available.
+     */
+    template <typename T>
+    T* allocate(size_t count) {
+        return m_arena.allocate<T>(count);
+    }
+};
+}  // namespace md
@@ -0,0 +1,536 @@
+#pragma once
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace md {
+namespace detail {
+/**
+ * \brief Blocks while a shared 32-bit word holds an expected value.
+ *
+ * \param word Futex word (may live in memory shared between processes).
+ * \param expected Value the word must still hold for the call to sleep.
+ */
+inline void futexWait(std::atomic<uint32_t>* word, uint32_t expected) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+}
+
+/**
+ * \brief Wakes every thread or process waiting on a shared 32-bit word.
+ *
+ * \param word Futex word.
+ */
+inline void futexWakeAll(std::atomic<uint32_t>* word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+}  // namespace detail
+
+/**
+ * \brief Block of samples claimed from a SharedRing.
+ *
+ * \tparam T Sample type.
+ */
+template <typename T>
+struct RingBlock {
+    /// @brief Samples, writable in place (nullptr once the ring is closed and drained)
+    T* data = nullptr;
+    /// @brief Number of samples
+    size_t length = 0;
+    /// @brief Position of the block in the published stream
+    uint64_t sequence = 0;
+
+    /// @brief Checks if a block was claimed
+    /// @return false once the producer has closed the ring and all blocks were claimed
+    explicit operator bool() const { return data != nullptr; }
+};
+
+/**
+ * \brief Shared-memory ring of sample blocks between processes.
+ *
+ * The ring lives in a memfd (or a named POSIX shared-memory object) that is
+ * mapped by the producing process and by one or more consuming processes.
+ * The producer writes each block directly into a slot and publishes it; a
+ * consumer claims the block and filters it in place, e.g. with
+ * Filter::process(block.data, block.length), then releases the slot for
+ * reuse. Samples are never serialized or copied between processes.
+ *
+ * There is a single producer. Every block is claimed by exactly one
+ * consumer, so several consumers share the work; block sequence numbers give
+ * the original order. A stateful filter that must see consecutive blocks
+ * therefore needs its own ring (or a single consumer).
+ *
+ * Blocked producers and consumers sleep on futex words inside the shared
+ * mapping, and wake-up system calls are only made when somebody is waiting,
+ * so a steady stream costs a few atomic operations per block.
+ *
+ * \tparam T Sample type (trivially copyable).
+ */
+template <typename T>
+class SharedRing {
+   private:
+    /// \brief Ring format identifier
+    static constexpr char kMagic[8] = {'M', 'D', 'R', 'I', 'N', 'G', '0', '1'};
+    /// \brief Alignment of the control block, slot headers and slot data
+    static constexpr size_t kAlignment = 64;
+
+    /// \brief Fixed description of a ring, written once by the creator
+    struct Layout {
+        /// @brief Ring format identifier
+        char magic[8];
+        /// @brief sizeof(T) of the producer
+        uint64_t sampleSize;
+        /// @brief Number of slots
+        uint64_t slotCount;
+        /// @brief Maximum number of samples per slot
+        uint64_t slotCapacity;
+    };
+
+    /// \brief Shared control block at the start of the mapping
+    struct Control {
+        /// @brief Ring description
+        Layout layout;
+        /// @brief Number of published blocks
+        alignas(kAlignment) std::atomic<uint64_t> published;
+        /// @brief Incremented on every publish and on close (futex word)
+        std::atomic<uint32_t> publishEvent;
+        /// @brief Number of consumers sleeping on publishEvent
+        std::atomic<uint32_t> publishWaiters;
+        /// @brief Set by the producer when no further blocks follow
+        std::atomic<uint32_t> closed;
+        /// @brief Number of claimed blocks
+        alignas(kAlignment) std::atomic<uint64_t> claimed;
+        /// @brief Incremented on every release (futex word)
+        alignas(kAlignment) std::atomic<uint32_t> releaseEvent;
+        /// @brief Number of producers sleeping on releaseEvent
+        std::atomic<uint32_t> releaseWaiters;
+    };
+
+    /// \brief Shared header of one slot
+    struct alignas(kAlignment) Slot {
+        /// @brief 2*lap when free for lap, 2*lap+1 when published in lap
+        std::atomic<uint64_t> turn;
+        /// @brief Number of published samples
+        uint64_t length;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared ring needs lock-free 64-bit atomics!");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared ring needs lock-free 32-bit atomics!");
+    static_assert(std::is_trivially_copyable<T>::value, "Sample type must be trivially copyable!");
+
+    /// \brief File descriptor of the shared memory
+    int m_fd = -1;
+    /// \brief Mapping of the whole ring
+    void* m_base = nullptr;
+    /// \brief Size of the mapping in bytes
+    size_t m_bytes = 0;
+    /// \brief Control block inside the mapping
+    Control* m_control = nullptr;
+    /// \brief Slot headers inside the mapping
+    Slot* m_slots = nullptr;
+    /// \brief Slot data inside the mapping
+    unsigned char* m_data = nullptr;
+    /// \brief Distance between slot data in bytes
+    size_t m_slotStride = 0;
+    /// \brief Sequence of the slot acquired by the producer
+    uint64_t m_next = 0;
+
+    /**
+     * \brief Rounds a byte count up to the alignment.
+     *
+     * \param bytes Byte count.
+     *
+     * \return Aligned byte count.
+     */
+    static size_t align(size_t bytes) { return (bytes + kAlignment - 1) / kAlignment * kAlignment; }
+
+    /**
+     * \brief Computes the layout and maps the shared memory.
+     *
+     * \param fd Shared memory descriptor (taken over).
+     * \param slotCount Number of slots.
+     * \param slotCapacity Maximum number of samples per slot.
+     */
+    void map(int fd, size_t slotCount, size_t slotCapacity) {
+        m_fd = fd;
+        m_slotStride = align(slotCapacity * sizeof(T));
+        m_bytes = align(sizeof(Control)) + slotCount * sizeof(Slot) + slotCount * m_slotStride;
+        void* base = ::mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            ::close(fd);
+            m_fd = -1;
+            throw std::runtime_error("Failed to map shared ring");
+        }
+        m_base = base;
+        m_control = static_cast<Control*>(base);
+        m_slots = reinterpret_cast<Slot*>(static_cast<unsigned char*>(base) + align(sizeof(Control)));
+        m_data = reinterpret_cast<unsigned char*>(m_slots + slotCount);
+    }
+
+    /**
+     * \brief Creates the ring in a new shared memory descriptor.
+     *
+     * \param fd Empty shared memory descriptor (taken over).
+     * \param slotCount Number of slots.
+     * \param slotCapacity Maximum number of samples per slot.
+     */
+    void initialize(int fd, size_t slotCount, size_t slotCapacity) {
+        size_t bytes = align(sizeof(Control)) + slotCount * sizeof(Slot) + slotCount * align(slotCapacity * sizeof(T));
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to size shared ring");
+        }
+        map(fd, slotCount, slotCapacity);
+        Control* control = new (m_base) Control();
+        control->layout.sampleSize = sizeof(T);
+        control->layout.slotCount = slotCount;
+        control->layout.slotCapacity = slotCapacity;
+        for (size_t s = 0; s < slotCount; s++) {
+            new (m_slots + s) Slot();
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(control->layout.magic, kMagic, sizeof(kMagic));
+    }
+
+    /**
+     * \brief Maps an existing ring.
+     *
+     * \param fd Shared memory descriptor of the ring (taken over).
+     */
+    void attachTo(int fd) {
+        struct stat info;
+        if (fd < 0 || ::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Control)) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::invalid_argument("Not a shared ring!");
+        }
+        Layout header;
+        if (::pread(fd, &header, sizeof(Layout), 0) != static_cast<ssize_t>(sizeof(Layout)) ||
+            std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.sampleSize != sizeof(T) ||
+            header.slotCount < 2 ||
+            static_cast<size_t>(info.st_size) < align(sizeof(Control)) + header.slotCount * sizeof(Slot) +
+                                                    header.slotCount * align(header.slotCapacity * sizeof(T))) {
+            ::close(fd);
+            throw std::invalid_argument("Not a shared ring!");
+        }
+        map(fd, static_cast<size_t>(header.slotCount), static_cast<size_t>(header.slotCapacity));
+    }
+
+    /// @brief Unmaps the ring and closes the descriptor
+    void release() {
+        if (m_base != nullptr) {
+            ::munmap(m_base, m_bytes);
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+        m_base = nullptr;
+        m_fd = -1;
+    }
+
+    /// @brief Gets data of the slot holding a sequence
+    T* slotData(uint64_t sequence) const {
+        return reinterpret_cast<T*>(m_data + (sequence % m_control->layout.slotCount) * m_slotStride);
+    }
+
+    /// @brief Gets header of the slot holding a sequence
+    Slot& slotOf(uint64_t sequence) const { return m_slots[sequence % m_control->layout.slotCount]; }
+
+    /// @brief Wakes consumers waiting for blocks
+    void signalPublish() {
+        m_control->publishEvent.fetch_add(1);
+        if (m_control->publishWaiters.load() > 0) {
+            detail::futexWakeAll(&m_control->publishEvent);
+        }
+    }
+
+    /// @brief Private constructor used by the factories
+    SharedRing() = default;
+
+   public:
+    /**
+     * \brief Creates a ring in an anonymous memfd.
+     *
+     * Other processes attach through the descriptor, inherited with fork()
+     * or passed over a Unix socket (SCM_RIGHTS), see fromFd().
+     *
+     * \param slotCount Number of slots (>= 2).
+     * \param slotCapacity Maximum number of samples per block.
+     *
+     * \return Ring owned by the producer.
+     *
+     * \throws std::invalid_argument if slotCount < 2 or slotCapacity is 0.
+     * \throws std::runtime_error if the shared memory cannot be created.
+     */
+    static SharedRing create(size_t slotCount, size_t slotCapacity) {
+        if (slotCount < 2 || slotCapacity == 0) {
+            throw std::invalid_argument("Ring needs at least two slots of positive capacity!");
+        }
+        int fd = ::memfd_create("md-shared-ring", MFD_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create shared ring");
+        }
+        SharedRing ring;
+        ring.initialize(fd, slotCount, slotCapacity);
+        return ring;
+    }
+
+    /**
+     * \brief Creates a ring in a named POSIX shared-memory object.
+     *
+     * \param name Object name (e.g. "/dsp-input"), must not exist yet.
+     * \param slotCount Number of slots (>= 2).
+     * \param slotCapacity Maximum number of samples per block.
+     *
+     * \return Ring owned by the producer.
+     *
+     * \throws std::invalid_argument if slotCount < 2 or slotCapacity is 0.
+     * \throws std::runtime_error if the object cannot be created.
+     */
+    static SharedRing create(const std::string& name, size_t slotCount, size_t slotCapacity) {
+        if (slotCount < 2 || slotCapacity == 0) {
+            throw std::invalid_argument("Ring needs at least two slots of positive capacity!");
+        }
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create shared ring");
+        }
+        SharedRing ring;
+        ring.initialize(fd, slotCount, slotCapacity);
+        return ring;
+    }
+
+    /**
+     * \brief Attaches to a ring through its descriptor.
+     *
+     * \param fd Descriptor of the ring, e.g. fd() of the creator (duplicated, the caller keeps it).
+     *
+     * \return Attached ring.
+     *
+     * \throws std::invalid_argument if fd is not a ring of sample type T.
+     */
+    static SharedRing fromFd(int fd) {
+        SharedRing ring;
+        ring.attachTo(fd >= 0 ? ::fcntl(fd, F_DUPFD_CLOEXEC, 0) : -1);
+        return ring;
+    }
+
+    /**
+     * \brief Attaches to a named ring.
+     *
+     * \param name Object name passed to create().
+     *
+     * \return Attached ring.
+     *
+     * \throws std::invalid_argument if the object does not exist or is not a ring of sample type T.
+     */
+    static SharedRing open(const std::string& name) {
+        SharedRing ring;
+        ring.attachTo(::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0));
+        return ring;
+    }
+
+    /**
+     * \brief Removes a named ring (mappings stay valid until closed).
+     *
+     * \param name Object name passed to create().
+     */
+    static void unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    SharedRing(const SharedRing&) = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+    /// @brief Move constructor
+    /// @param other Ring to take over
+    SharedRing(SharedRing&& other) noexcept { *this = std::move(other); }
+
+    /// @brief Move assignment operator
+    /// @param other Ring to take over
+    /// @return Reference to this ring
+    SharedRing& operator=(SharedRing&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_fd = std::exchange(other.m_fd, -1);
+            m_base = std::exchange(other.m_base, nullptr);
+            m_bytes = other.m_bytes;
+            m_control = other.m_control;
+            m_slots = other.m_slots;
+            m_data = other.m_data;
+            m_slotStride = other.m_slotStride;
+            m_next = other.m_next;
+        }
+        return *this;
+    }
+
+    /// @brief Unmaps the ring
+    ~SharedRing() { release(); }
+
+    /**
+     * \brief Waits for a free slot and returns it for writing (producer).
+     *
+     * \return Slot data of slotCapacity() samples, to be followed by publish().
+     */
+    T* acquire() {
+        Slot& slot = slotOf(m_next);
+        const uint64_t free = 2 * (m_next / m_control->layout.slotCount);
+        while (slot.turn.load(std::memory_order_acquire) != free) {
+            uint32_t event = m_control->releaseEvent.load(std::memory_order_acquire);
+            m_control->releaseWaiters.fetch_add(1);
+            if (slot.turn.load() != free) {
+                detail::futexWait(&m_control->releaseEvent, event);
+            }
+            m_control->releaseWaiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return slotData(m_next);
+    }
+
+    /**
+     * \brief Publishes the slot returned by acquire() (producer).
+     *
+     * \param length Number of samples written (<= slotCapacity()).
+     *
+     * \throws std::invalid_argument if length exceeds the slot capacity.
+     */
+    void publish(size_t length) {
+        if (length > m_control->layout.slotCapacity) {
+            throw std::invalid_argument("Block exceeds slot capacity!");
+        }
+        Slot& slot = slotOf(m_next);
+        slot.length = length;
+        slot.turn.store(2 * (m_next / m_control->layout.slotCount) + 1, std::memory_order_release);
+        m_next++;
+        m_control->published.store(m_next, std::memory_order_release);
+        signalPublish();
+    }
+
+    /**
+     * \brief Copies a block into the next slot and publishes it (producer).
+     *
+     * \param data Samples to publish.
+     * \param length Number of samples (<= slotCapacity()).
+     *
+     * \throws std::invalid_argument if data is nullptr or length exceeds the slot capacity.
+     */
+    void publish(const T* data, size_t length) {
+        if (data == nullptr || length > m_control->layout.slotCapacity) {
+            throw std::invalid_argument("Bad array!");
+        }
+        T* slot = acquire();
+        std::copy(data, data + length, slot);
+        publish(length);
+    }
+
+    /// @brief Marks the end of the stream (producer); consumers drain the remaining blocks
+    void close() {
+        m_control->closed.store(1, std::memory_order_release);
+        signalPublish();
+    }
+
+    /**
+     * \brief Claims the next published block without waiting (consumer).
+     *
+     * \param block Claimed block.
+     *
+     * \return true if a block was claimed.
+     */
+    bool tryClaim(RingBlock<T>& block) {
+        uint64_t claimed = m_control->claimed.load(std::memory_order_acquire);
+        while (claimed < m_control->published.load(std::memory_order_acquire)) {
+            if (m_control->claimed.compare_exchange_weak(claimed, claimed + 1, std::memory_order_acq_rel)) {
+                Slot& slot = slotOf(claimed);
+                block.data = slotData(claimed);
+                block.length = static_cast<size_t>(slot.length);
+                block.sequence = claimed;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * \brief Waits for and claims the next published block (consumer).
+     *
+     * \return Claimed block, or an empty block once the ring is closed and drained.
+     */
+    RingBlock<T> claim() {
+        RingBlock<T> block;
+        while (!tryClaim(block)) {
+            uint32_t event = m_control->publishEvent.load(std::memory_order_acquire);
+            if (m_control->closed.load(std::memory_order_acquire) != 0 &&
+                m_control->claimed.load(std::memory_order_acquire) >=
+                    m_control->published.load(std::memory_order_acquire)) {
+                return RingBlock<T>();
+            }
+            m_control->publishWaiters.fetch_add(1);
+            if (m_control->claimed.load() >= m_control->published.load()) {
+                detail::futexWait(&m_control->publishEvent, event);
+            }
+            m_control->publishWaiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return block;
+    }
+
+    /**
+     * \brief Returns a claimed block's slot to the producer (consumer).
+     *
+     * \param block Block returned by claim() or tryClaim().
+     */
+    void release(const RingBlock<T>& block) {
+        if (!block) {
+            return;
+        }
+        uint64_t lap = block.sequence / m_control->layout.slotCount;
+        slotOf(block.sequence).turn.store(2 * lap + 2, std::memory_order_release);
+        m_control->releaseEvent.fetch_add(1);
+        if (m_control->releaseWaiters.load() > 0) {
+            detail::futexWakeAll(&m_control->releaseEvent);
+        }
+    }
+
+    /**
+     * \brief Claims, processes in place and releases blocks until the ring is closed (consumer).
+     *
+     * \param processor Object with process(T*, size_t), e.g. a Filter or a DynamicFilter.
+     *
+     * \return Number of processed blocks.
+     */
+    template <typename Processor>
+    size_t consume(Processor& processor) {
+        size_t count = 0;
+        while (RingBlock<T> block = claim()) {
+            if (block.length > 0) {
+                processor.process(block.data, block.length);
+            }
+            release(block);
+            count++;
+        }
+        return count;
+    }
+
+    /// @brief Gets the shared memory descriptor (e.g. to pass to another process)
+    /// @return File descriptor
+    int fd() const { return m_fd; }
+
+    /// @brief Gets number of slots
+    /// @return Slot count
+    size_t slotCount() const { return static_cast<size_t>(m_control->layout.slotCount); }
+
+    /// @brief Gets maximum number of samples per block
+    /// @return Slot capacity
+    size_t slotCapacity() const { return static_cast<size_t>(m_control->layout.slotCapacity); }
+};
+}  // namespace md
@@ -213,10 +213,8 @@ class Signal {
      * \return A new signal containing the element-wise sum.
      */
     Signal operator+(const Signal<T, Size>& other) const {
-        Signal result;
-        for (size_t i = 0; i < Size; i++) {
-            result.m_samples[i] = m_samples[i] + other.m_samples[i];
-        }
+        Signal result(*this);
+        result += other;
         return result;
     }
 
@@ -248,10 +246,8 @@ class Signal {
      * \return A new signal containing the element-wise difference.
      */
     Signal operator-(const Signal<T, Size>& other) const {
-        Signal result;
-        for (size_t i = 0; i < Size; i++) {
-            result.m_samples[i] = m_samples[i] - other.m_samples[i];
-        }
+        Signal result(*this);
+        result -= other;
         return result;
     }
 
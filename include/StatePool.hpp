@@ -0,0 +1,174 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace md {
+/**
+ * \brief Dense storage of filter states for many streams.
+ *
+ * Keeps the states of many independent streams of one filter design in a
+ * single contiguous array and hands out compact handles to them. A single
+ * configured filter then processes a block of any stream through
+ * process(State&, T*, size_t), so its coefficients stay cache-hot across
+ * streams and each stream costs exactly one State:
+ * \code
+ * StatePool<FirFilter<float, 64>> pool;
+ * StatePool<FirFilter<float, 64>>::Handle stream = pool.acquire();
+ * pool.process(filter, stream, block, length);
+ * \endcode
+ * Released slots are reused by later acquire() calls, so the array never
+ * grows beyond the largest number of simultaneously active streams.
+ *
+ * \tparam FilterType Filter with a State type and process(State&, T*, size_t),
+ *         e.g. FirFilter<T, Size> or IirFilter<T, NumB, NumA>.
+ */
+template <typename FilterType>
+class StatePool {
+   public:
+    /// @brief State of one stream
+    using State = typename FilterType::State;
+    /// @brief Identifies a stream's state in the pool
+    using Handle = uint32_t;
+
+   private:
+    /// \brief States by handle
+    std::vector<State> m_states;
+    /// \brief Active flag by handle
+    std::vector<uint8_t> m_active;
+    /// \brief Released handles, reused last-in first-out
+    std::vector<Handle> m_free;
+
+    /**
+     * \brief Validates a handle.
+     *
+     * \param handle Handle to check.
+     *
+     * \throws std::out_of_range if the handle is not active.
+     */
+    void check(Handle handle) const {
+        if (handle >= m_states.size() || !m_active[handle]) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates an empty pool.
+     *
+     * \param capacity Number of states to reserve room for.
+     */
+    explicit StatePool(size_t capacity = 0) {
+        m_states.reserve(capacity);
+        m_active.reserve(capacity);
+    }
+
+    /**
+     * \brief Adds a stream with a cleared state.
+     *
+     * \return Handle of the new stream.
+     *
+     * \throws std::length_error if no more handles are available.
+     */
+    Handle acquire() {
+        if (!m_free.empty()) {
+            Handle handle = m_free.back();
+            m_free.pop_back();
+            m_states[handle] = State{};
+            m_active[handle] = 1;
+            return handle;
+        }
+        if (m_states.size() >= UINT32_MAX) {
+            throw std::length_error("State pool is full!");
+        }
+        m_states.emplace_back();
+        m_active.push_back(1);
+        return static_cast<Handle>(m_states.size() - 1);
+    }
+
+    /**
+     * \brief Removes a stream, its slot is reused by a later acquire().
+     *
+     * \param handle Handle from acquire().
+     *
+     * \throws std::out_of_range if the handle is not active.
+     */
+    void release(Handle handle) {
+        check(handle);
+        m_active[handle] = 0;
+        m_free.push_back(handle);
+    }
+
+    /**
+     * \brief Filters a block of one stream.
+     *
+     * \param filter Configured filter (its own state is not used).
+     * \param handle Stream to process.
+     * \param signal Pointer to the signal array to process in-place.
+     * \param length Number of samples in the signal array.
+     *
+     * \throws std::out_of_range if the handle is not active.
+     * \throws std::invalid_argument if signal is nullptr or length is 0.
+     */
+    template <typename T>
+    void process(const FilterType& filter, Handle handle, T* signal, size_t length) {
+        check(handle);
+        filter.process(m_states[handle], signal, length);
+    }
+
+    /**
+     * \brief Clears the state of a stream.
+     *
+     * \param handle Stream to clear.
+     *
+     * \throws std::out_of_range if the handle is not active.
+     */
+    void reset(Handle handle) {
+        check(handle);
+        m_states[handle] = State{};
+    }
+
+    /// @brief Unchecked state access
+    /// @param handle Active handle
+    /// @return Reference to the stream's state
+    State& operator[](Handle handle) { return m_states[handle]; }
+    /// @brief Unchecked const state access
+    /// @param handle Active handle
+    /// @return Const reference to the stream's state
+    const State& operator[](Handle handle) const { return m_states[handle]; }
+
+    /**
+     * \brief Checked state access.
+     *
+     * \param handle Handle from acquire().
+     *
+     * \return Reference to the stream's state.
+     *
+     * \throws std::out_of_range if the handle is not active.
+     */
+    State& at(Handle handle) {
+        check(handle);
+        return m_states[handle];
+    }
+
+    /// @brief Checks if a handle refers to an active stream
+    /// @param handle Handle to check
+    /// @return true if the handle was acquired and not released
+    bool isActive(Handle handle) const { return handle < m_states.size() && m_active[handle]; }
+
+    /// @brief Gets number of active streams
+    /// @return Number of acquired, unreleased handles
+    size_t size() const { return m_states.size() - m_free.size(); }
+
+    /// @brief Gets number of allocated slots
+    /// @return Number of active and released slots
+    size_t slots() const { return m_states.size(); }
+
+    /// @brief Releases every stream
+    void clear() {
+        m_states.clear();
+        m_active.clear();
+        m_free.clear();
+    }
+};
+}  // namespace md
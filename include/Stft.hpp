@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <complex>
+
+#include "AlignedBuffer.hpp"
+#include "Fft.hpp"
+#include "Window.hpp"
+
+namespace md {
+/**
+ * \brief Streaming Short-Time Fourier Transform.
+ *
+ * Cuts a continuous signal into frames of Size samples spaced hop samples
+ * apart, applies a Window to each frame and computes its real FFT. Like
+ * Filter, the object keeps the tail of the previous block, so a signal can be
+ * delivered in blocks of any length and yields the same frames as if it were
+ * processed at once. Each call writes as many complete frames as became
+ * available; use maxFrames() to size the output.
+ *
+ * \tparam T Data type (must be floating-point).
+ * \tparam Size Frame length and FFT size (must be a power of two).
+ */
+template <typename T, size_t Size>
+class Stft {
+   private:
+    /// \brief Window applied to each frame
+    Window<T, Size> m_window;
+    /// \brief Real FFT of one frame
+    RealFft<T> m_fft;
+    /// \brief Distance between consecutive frames
+    size_t m_hop;
+    /// \brief Most recent input samples (up to Size)
+    AlignedBuffer<T> m_buffer;
+    /// \brief Number of valid samples in m_buffer
+    size_t m_filled = 0;
+    /// \brief Windowed copy of the current frame
+    AlignedBuffer<T> m_frame;
+
+    /**
+     * \brief Consumes input and calls a function for each completed frame.
+     *
+     * \param signal Input samples.
+     * \param length Number of input samples.
+     * \param emit Called with the windowed frame and the frame index.
+     *
+     * \return Number of frames emitted.
+     */
+    template <typename Emit>
+    size_t consume(const T* signal, size_t length, Emit emit) {
+        size_t frames = 0;
+        size_t pos = 0;
+        while (pos < length) {
+            size_t count = std::min(length - pos, Size - m_filled);
+            std::copy(signal + pos, signal + pos + count, m_buffer.data() + m_filled);
+            m_filled += count;
+            pos += count;
+            if (m_filled == Size) {
+                std::copy(m_buffer.data(), m_buffer.data() + Size, m_frame.data());
+                m_window.process(m_frame.data(), Size);
+                emit(m_frame.data(), frames++);
+                std::copy(m_buffer.data() + m_hop, m_buffer.data() + Size, m_buffer.data());
+                m_filled = Size - m_hop;
+            }
+        }
+        return frames;
+    }
+
+   public:
+    /**
+     * \brief Creates a transform with a window and hop size.
+     *
+     * \param window Window applied to every frame.
+     * \param hop Distance between frame starts (0 < hop <= Size).
+     *
+     * \throws std::invalid_argument if hop is 0 or larger than Size.
+     * \throws std::invalid_argument if Size is not a power of two (via RealFft).
+     */
+    Stft(const Window<T, Size>& window, size_t hop) : m_window(window), m_fft(Size), m_hop(hop) {
+        if (hop == 0 || hop > Size) {
+            throw std::invalid_argument("Hop size must be in range (0, Size]!");
+        }
+        m_buffer.resize(Size);
+        m_frame.resize(Size);
+    }
+
+    /**
+     * \brief Gets the largest number of frames a block can produce.
+     *
+     * \param length Number of samples in the next block.
+     *
+     * \return Upper bound of frames written by process()/processPower().
+     */
+    size_t maxFrames(size_t length) const {
+        size_t total = m_filled + length;
+        return total < Size ? 0 : (total - Size) / m_hop + 1;
+    }
+
+    /**
+     * \brief Processes a block and writes complex spectra.
+     *
+     * \param signal Pointer to the input block.
+     * \param length Number of samples in the block.
+     * \param spectra Output, frames x bins() values (row per frame).
+     *
+     * \return Number of frames written.
+     *
+     * \throws std::invalid_argument if signal or spectra is nullptr.
+     */
+    size_t process(const T* signal, size_t length, std::complex<T>* spectra) {
+        if (signal == nullptr || spectra == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        return consume(signal, length,
+                       [&](const T* frame, size_t index) { m_fft.forward(frame, spectra + index * bins()); });
+    }
+
+    /**
+     * \brief Processes a block and writes power spectra.
+     *
+     * \param signal Pointer to the input block.
+     * \param length Number of samples in the block.
+     * \param power Output, frames x bins() values (row per frame).
+     *
+     * \return Number of frames written.
+     *
+     * \throws std::invalid_argument if signal or power is nullptr.
+     */
+    size_t processPower(const T* signal, size_t length, T* power) {
+        if (signal == nullptr || power == nullptr) {
+            throw std::invalid_argument("Bad array!");
+        }
+        return consume(signal, length,
+                       [&](const T* frame, size_t index) { m_fft.power(frame, power + index * bins()); });
+    }
+
+    /**
+     * \brief Resets the transform to its initial state.
+     *
+     * Drops buffered samples so a new, independent signal can start.
+     */
+    void reset() {
+        m_buffer.fill(static_cast<T>(0.0));
+        m_filled = 0;
+    }
+
+    /// @brief Gets number of bins per frame
+    /// @return Size/2+1
+    static constexpr size_t bins() { return Size / 2 + 1; }
+
+    /// @brief Gets hop size
+    /// @return Distance between frames
+    size_t hop() const { return m_hop; }
+};
+}  // namespace md
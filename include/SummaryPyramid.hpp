@@ -0,0 +1,438 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace md {
+/**
+ * \brief Min, max and RMS of a range of samples.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+struct BlockSummary {
+    /// @brief Smallest sample
+    T min;
+    /// @brief Largest sample
+    T max;
+    /// @brief Mean of the squared samples (RMS squared)
+    T meanSquare;
+
+    /// @brief Gets the root mean square
+    /// @return sqrt(meanSquare)
+    T rms() const { return std::sqrt(meanSquare); }
+
+    /// @brief Gets the largest magnitude
+    /// @return max(|min|, |max|)
+    T peak() const { return std::max(std::abs(min), std::abs(max)); }
+};
+
+/**
+ * \brief Persistent multi-resolution min/max/RMS index of a long signal.
+ *
+ * Level 0 summarizes blocks of blockSize() samples, every further level
+ * merges pairs of blocks of the level below, up to a single block covering
+ * the whole signal. The index is built in one streaming pass (append() may
+ * be called with any chunk sizes) and can be saved to a small sidecar file,
+ * about 3 / blockSize() of the signal size. Afterwards range queries are
+ * answered from O(log N) blocks without touching the raw samples, e.g. to
+ * draw envelopes or to locate active regions of multi-GB recordings.
+ *
+ * Query ranges are rounded outwards to level-0 block boundaries, so results
+ * are exact for block-aligned ranges and cover a slightly larger range
+ * otherwise; the block size sets this granularity.
+ *
+ * \tparam T Data type (must be floating-point).
+ */
+template <typename T>
+class SummaryPyramid {
+   private:
+    /// \brief Sidecar file format identifier
+    static constexpr char kMagic[8] = {'M', 'D', 'P', 'Y', 'R', 'A', 'M', '1'};
+
+    /// \brief Number of samples per level-0 block (power of two)
+    size_t m_blockSize = 0;
+    /// \brief Number of summarized samples
+    size_t m_length = 0;
+    /// \brief Summaries per level, level 0 first
+    std::vector<std::vector<BlockSummary<T>>> m_levels;
+    /// \brief Partial level-0 block being appended
+    BlockSummary<T> m_pending{};
+    /// \brief Number of samples in the partial block
+    size_t m_pendingCount = 0;
+    /// \brief Set once the upper levels are built
+    bool m_finished = false;
+
+    /**
+     * \brief Merges two adjacent summaries.
+     *
+     * \param a First summary.
+     * \param countA Number of samples of a.
+     * \param b Second summary.
+     * \param countB Number of samples of b.
+     *
+     * \return Summary of both ranges.
+     */
+    static BlockSummary<T> merge(const BlockSummary<T>& a, size_t countA, const BlockSummary<T>& b, size_t countB) {
+        T total = static_cast<T>(countA + countB);
+        return BlockSummary<T>{std::min(a.min, b.min), std::max(a.max, b.max),
+                               (a.meanSquare * static_cast<T>(countA) + b.meanSquare * static_cast<T>(countB)) / total};
+    }
+
+    /**
+     * \brief Gets number of samples covered by a block.
+     *
+     * \param level Pyramid level.
+     * \param index Block index within the level.
+     *
+     * \return Number of samples (smaller than the nominal size for the last block).
+     */
+    size_t blockLength(size_t level, size_t index) const {
+        size_t size = m_blockSize << level;
+        size_t begin = index * size;
+        return std::min(m_length, begin + size) - begin;
+    }
+
+    /// @brief Closes the partial block and builds the upper levels
+    void build() {
+        if (m_pendingCount > 0) {
+            m_pending.meanSquare /= static_cast<T>(m_pendingCount);
+            m_levels[0].push_back(m_pending);
+            m_pendingCount = 0;
+        }
+        m_levels.resize(1);
+        while (m_levels.back().size() > 1) {
+            size_t level = m_levels.size() - 1;
+            const std::vector<BlockSummary<T>>& below = m_levels[level];
+            std::vector<BlockSummary<T>> above((below.size() + 1) / 2);
+            for (size_t i = 0; i < above.size(); i++) {
+                if (2 * i + 1 < below.size()) {
+                    above[i] = merge(below[2 * i], blockLength(level, 2 * i), below[2 * i + 1],
+                                     blockLength(level, 2 * i + 1));
+                } else {
+                    above[i] = below[2 * i];
+                }
+            }
+            m_levels.push_back(std::move(above));
+        }
+        m_finished = true;
+    }
+
+    /**
+     * \brief Collects active ranges below a block.
+     *
+     * \param level Block level.
+     * \param index Block index.
+     * \param threshold Magnitude threshold.
+     * \param ranges Output ranges, merged when adjacent.
+     */
+    void collectActive(size_t level, size_t index, T threshold, std::vector<std::pair<size_t, size_t>>& ranges) const {
+        if (m_levels[level][index].peak() <= threshold) {
+            return;
+        }
+        if (level == 0) {
+            size_t begin = index * m_blockSize;
+            size_t end = begin + blockLength(0, index);
+            if (!ranges.empty() && ranges.back().second == begin) {
+                ranges.back().second = end;
+            } else {
+                ranges.emplace_back(begin, end);
+            }
+            return;
+        }
+        collectActive(level - 1, 2 * index, threshold, ranges);
+        if (2 * index + 1 < m_levels[level - 1].size()) {
+            collectActive(level - 1, 2 * index + 1, threshold, ranges);
+        }
+    }
+
+    /// @brief Throws if the pyramid is not finished
+    void requireFinished() const {
+        if (!m_finished || m_length == 0) {
+            throw std::logic_error("Pyramid is empty or not finished!");
+        }
+    }
+
+   public:
+    /**
+     * \brief Creates an empty pyramid for streaming construction.
+     *
+     * \param blockSize Number of samples per level-0 block (power of two).
+     *
+     * \throws std::invalid_argument if blockSize is not a power of two.
+     */
+    explicit SummaryPyramid(size_t blockSize = 256) : m_blockSize(blockSize) {
+        static_assert(std::is_floating_point<T>::value, "Template type T must be a floating point type!");
+        if (blockSize == 0 || (blockSize & (blockSize - 1)) != 0) {
+            throw std::invalid_argument("Block size must be a power of two!");
+        }
+        m_levels.resize(1);
+    }
+
+    /**
+     * \brief Appends samples to the summarized signal.
+     *
+     * \param signal Samples to append.
+     * \param length Number of samples.
+     *
+     * \throws std::invalid_argument if signal is nullptr.
+     * \throws std::logic_error if finish() was already called.
+     */
+    void append(const T* signal, size_t length) {
+        if (signal == nullptr && length > 0) {
+            throw std::invalid_argument("Bad array!");
+        }
+        if (m_finished) {
+            throw std::logic_error("Pyramid is already finished!");
+        }
+        size_t pos = 0;
+        while (pos < length) {
+            if (m_pendingCount == 0) {
+                m_pending = BlockSummary<T>{std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+                                            static_cast<T>(0.0)};
+            }
+            size_t count = std::min(length - pos, m_blockSize - m_pendingCount);
+            const T* x = signal + pos;
+            T low = m_pending.min;
+            T high = m_pending.max;
+            T energy = static_cast<T>(0.0);
+            for (size_t i = 0; i < count; i++) {
+                low = std::min(low, x[i]);
+                high = std::max(high, x[i]);
+                energy += x[i] * x[i];
+            }
+            m_pending.min = low;
+            m_pending.max = high;
+            m_pending.meanSquare += energy;
+            m_pendingCount += count;
+            m_length += count;
+            pos += count;
+            if (m_pendingCount == m_blockSize) {
+                m_pending.meanSquare /= static_cast<T>(m_blockSize);
+                m_levels[0].push_back(m_pending);
+                m_pendingCount = 0;
+            }
+        }
+    }
+
+    /// @brief Completes construction; required before queries and save()
+    void finish() {
+        if (!m_finished) {
+            build();
+        }
+    }
+
+    /**
+     * \brief Summarizes a range of samples.
+     *
+     * \param begin First sample.
+     * \param end One past the last sample.
+     *
+     * \return Summary of the range rounded outwards to level-0 blocks.
+     *
+     * \throws std::out_of_range if begin >= end or end > length().
+     * \throws std::logic_error if the pyramid is not finished.
+     */
+    BlockSummary<T> query(size_t begin, size_t end) const {
+        requireFinished();
+        if (begin >= end || end > m_length) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        size_t first = begin / m_blockSize;
+        size_t last = (end + m_blockSize - 1) / m_blockSize;
+        BlockSummary<T> result{};
+        size_t count = 0;
+        auto add = [&](size_t level, size_t index) {
+            size_t length = blockLength(level, index);
+            result = count == 0 ? m_levels[level][index] : merge(result, count, m_levels[level][index], length);
+            count += length;
+        };
+        for (size_t level = 0; first < last; level++) {
+            if (first & 1) {
+                add(level, first++);
+            }
+            if (last & 1) {
+                add(level, --last);
+            }
+            first /= 2;
+            last /= 2;
+        }
+        return result;
+    }
+
+    /**
+     * \brief Computes a display envelope.
+     *
+     * Splits [begin, end) into numPoints equal parts and summarizes each.
+     *
+     * \param begin First sample.
+     * \param end One past the last sample.
+     * \param numPoints Number of envelope points (<= end - begin).
+     *
+     * \return Summary of every part.
+     *
+     * \throws std::out_of_range if the range is invalid.
+     * \throws std::invalid_argument if numPoints is 0 or larger than the range.
+     */
+    std::vector<BlockSummary<T>> envelope(size_t begin, size_t end, size_t numPoints) const {
+        if (begin >= end || end > m_length) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        if (numPoints == 0 || numPoints > end - begin) {
+            throw std::invalid_argument("Invalid number of envelope points!");
+        }
+        std::vector<BlockSummary<T>> points(numPoints);
+        size_t span = end - begin;
+        for (size_t p = 0; p < numPoints; p++) {
+            points[p] = query(begin + span * p / numPoints, begin + span * (p + 1) / numPoints);
+        }
+        return points;
+    }
+
+    /**
+     * \brief Finds regions whose magnitude exceeds a threshold.
+     *
+     * Descends only into blocks whose peak exceeds the threshold, so quiet
+     * parts of the signal cost one comparison per top-level block.
+     *
+     * \param threshold Magnitude threshold.
+     *
+     * \return Sample ranges [begin, end) at level-0 block granularity, in order.
+     *
+     * \throws std::logic_error if the pyramid is not finished.
+     */
+    std::vector<std::pair<size_t, size_t>> findActive(T threshold) const {
+        requireFinished();
+        std::vector<std::pair<size_t, size_t>> ranges;
+        collectActive(m_levels.size() - 1, 0, threshold, ranges);
+        return ranges;
+    }
+
+    /**
+     * \brief Saves the pyramid to a sidecar file.
+     *
+     * \param path Output file path.
+     *
+     * \throws std::logic_error if the pyramid is not finished.
+     * \throws std::invalid_argument if the file cannot be opened for writing.
+     */
+    void save(std::string_view path) const {
+        if (!m_finished) {
+            throw std::logic_error("Pyramid is not finished!");
+        }
+        std::ofstream file(std::string(path), std::ios::binary);
+        if (!file) {
+            throw std::invalid_argument("File can not be open!");
+        }
+        uint64_t header[4] = {sizeof(T), m_blockSize, m_length, m_levels.size()};
+        file.write(kMagic, sizeof(kMagic));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (const std::vector<BlockSummary<T>>& level : m_levels) {
+            file.write(reinterpret_cast<const char*>(level.data()), level.size() * sizeof(BlockSummary<T>));
+        }
+        if (!file) {
+            throw std::runtime_error("Failed to write data");
+        }
+    }
+
+    /**
+     * \brief Loads a pyramid from a sidecar file.
+     *
+     * \param path Sidecar file path.
+     *
+     * \return Finished pyramid.
+     *
+     * \throws std::invalid_argument if the file cannot be opened.
+     * \throws std::runtime_error if the file is truncated, corrupt or of another format or sample type.
+     */
+    static SummaryPyramid load(std::string_view path) {
+        std::ifstream file(std::string(path), std::ios::binary);
+        if (!file) {
+            throw std::invalid_argument("File can not be open!");
+        }
+        file.seekg(0, std::ios::end);
+        std::streamoff fileSize = file.tellg();
+        file.seekg(0, std::ios::beg);
+        char magic[sizeof(kMagic)];
+        uint64_t header[4];
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!file || fileSize < 0 || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || header[0] != sizeof(T)) {
+            throw std::runtime_error("Failed to read data");
+        }
+        const uint64_t blockSize = header[1];
+        const uint64_t length = header[2];
+        if (blockSize == 0 || (blockSize & (blockSize - 1)) != 0) {
+            throw std::runtime_error("Failed to read data");
+        }
+
+        // The level count and the file size follow from the length; check both before allocating
+        uint64_t levels = 1;
+        uint64_t totalBlocks = 0;
+        for (uint64_t blocks = length / blockSize + (length % blockSize != 0 ? 1 : 0);; blocks = (blocks + 1) / 2) {
+            totalBlocks += blocks;
+            if (blocks <= 1) {
+                break;
+            }
+            levels++;
+        }
+        uint64_t payload = static_cast<uint64_t>(fileSize) - sizeof(kMagic) - sizeof(header);
+        if (header[3] != levels || totalBlocks > payload / sizeof(BlockSummary<T>) ||
+            totalBlocks * sizeof(BlockSummary<T>) != payload) {
+            throw std::runtime_error("Failed to read data");
+        }
+
+        SummaryPyramid pyramid(static_cast<size_t>(blockSize));
+        pyramid.m_length = static_cast<size_t>(length);
+        pyramid.m_levels.resize(static_cast<size_t>(levels));
+        size_t blocks = static_cast<size_t>(length / blockSize + (length % blockSize != 0 ? 1 : 0));
+        for (std::vector<BlockSummary<T>>& level : pyramid.m_levels) {
+            level.resize(blocks);
+            file.read(reinterpret_cast<char*>(level.data()), blocks * sizeof(BlockSummary<T>));
+            blocks = (blocks + 1) / 2;
+        }
+        if (!file) {
+            throw std::runtime_error("Failed to read data");
+        }
+        pyramid.m_finished = true;
+        return pyramid;
+    }
+
+    /// @brief Gets number of summarized samples
+    /// @return Signal length
+    size_t length() const { return m_length; }
+
+    /// @brief Gets number of samples per level-0 block
+    /// @return Block size
+    size_t blockSize() const { return m_blockSize; }
+
+    /// @brief Gets number of levels
+    /// @return Number of levels (0 before finish())
+    size_t levels() const { return m_finished ? m_levels.size() : 0; }
+
+    /**
+     * \brief Gets the summaries of one level.
+     *
+     * \param level Level (0 = finest).
+     *
+     * \return Block summaries; block i covers samples [i, i+1) * (blockSize() << level).
+     *
+     * \throws std::out_of_range if level >= levels().
+     */
+    const std::vector<BlockSummary<T>>& level(size_t level) const {
+        if (level >= levels()) {
+            throw std::out_of_range("Index out of bounds!");
+        }
+        return m_levels[level];
+    }
+};
+}  // namespace md
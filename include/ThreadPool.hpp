@@ -0,0 +1,135 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace md {
+/**
+ * \brief Fixed-size pool of worker threads.
+ *
+ * Runs submitted tasks on a set of threads created once at construction, so
+ * processors that parallelize their work do not pay thread start-up on every
+ * call. parallelFor() splits an index range into one contiguous chunk per
+ * worker and passes the chunk number to the body, which lets callers keep
+ * per-chunk partial results (e.g. accumulators) without any locking.
+ */
+class ThreadPool {
+   private:
+    /// \brief Worker threads
+    std::vector<std::thread> m_workers;
+    /// \brief Pending tasks
+    std::deque<std::function<void()>> m_tasks;
+    /// \brief Protects m_tasks and m_stop
+    std::mutex m_mutex;
+    /// \brief Signals new tasks or shutdown
+    std::condition_variable m_condition;
+    /// \brief Set when the pool is being destroyed
+    bool m_stop = false;
+
+    /// @brief Worker loop: runs tasks until the pool stops
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if (m_stop && m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+   public:
+    /**
+     * \brief Starts the worker threads.
+     *
+     * \param numThreads Number of workers (0 = std::thread::hardware_concurrency()).
+     */
+    explicit ThreadPool(size_t numThreads = 0) {
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_workers.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; i++) {
+            m_workers.emplace_back([this] { run(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// @brief Finishes pending tasks and joins all workers
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * \brief Queues a task for execution.
+     *
+     * \param task Callable without arguments.
+     *
+     * \return Future delivering the task result (or its exception).
+     */
+    template <typename Task>
+    auto submit(Task&& task) -> std::future<typename std::invoke_result<Task>::type> {
+        using Result = typename std::invoke_result<Task>::type;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace_back([packaged] { (*packaged)(); });
+        }
+        m_condition.notify_one();
+        return result;
+    }
+
+    /**
+     * \brief Runs a body over [0, count) split into one chunk per worker.
+     *
+     * Blocks until all chunks are done. The first exception thrown by a
+     * chunk is rethrown after every chunk has finished.
+     *
+     * \param count Number of indices.
+     * \param body Callable body(chunk, begin, end) with chunk < size().
+     */
+    template <typename Body>
+    void parallelFor(size_t count, Body&& body) {
+        size_t chunks = std::min(count, m_workers.size());
+        std::vector<std::future<void>> pending;
+        pending.reserve(chunks);
+        for (size_t c = 0; c < chunks; c++) {
+            size_t begin = count * c / chunks;
+            size_t end = count * (c + 1) / chunks;
+            pending.push_back(submit([&body, c, begin, end] { body(c, begin, end); }));
+        }
+        for (std::future<void>& future : pending) {
+            future.wait();
+        }
+        for (std::future<void>& future : pending) {
+            future.get();
+        }
+    }
+
+    /// @brief Gets number of workers
+    /// @return Number of threads
+    size_t size() const { return m_workers.size(); }
+};
+}  // namespace md
@@ -1,13 +1,16 @@
 #pragma once
+#include <algorithm>
 #include <cmath>
 
+#include "Dpss.hpp"
+#include "FastMath.hpp"
 #include "SignalProcessor.hpp"
 namespace md {
 /**
  * \brief Window functions for signal processing.
  *
  * Provides various window functions used in spectral analysis and filter design.
- * Supports rectangular, Hamming, Hann, and Blackman windows.
+ * Supports rectangular, Hamming, Hann, Blackman and Slepian (DPSS) windows.
  *
  * \tparam T Data type (must be floating-point).
  * \tparam Size Window size (number of samples).
@@ -59,7 +62,7 @@ class Window : public SignalProcessor<T, Size> {
         for (size_t i = 0; i < Size; i++) {
             T n = static_cast<T>(i);
             T N = static_cast<T>(Size - 1);
-            T val = 0.54 - 0.46 * std::cos((2.0 * M_PI * n) / N);
+            T val = 0.54 - 0.46 * FastMath<T>::cos((2.0 * M_PI * n) / N);
             this->m_factors[i] = static_cast<T>(val);
         }
     }
@@ -78,7 +81,7 @@ class Window : public SignalProcessor<T, Size> {
         for (size_t i = 0; i < Size; i++) {
             T n = static_cast<T>(i);
             T N = static_cast<T>(Size - 1);
-            T val = 0.5 * (1.0 - std::cos((2.0 * M_PI * n) / N));
+            T val = 0.5 * (1.0 - FastMath<T>::cos((2.0 * M_PI * n) / N));
             this->m_factors[i] = static_cast<T>(val);
         }
     }
@@ -97,13 +100,39 @@ class Window : public SignalProcessor<T, Size> {
         for (size_t i = 0; i < Size; i++) {
             T n = static_cast<T>(i);
             T N = static_cast<T>(Size - 1);
-            T term1 = std::cos((2.0 * M_PI * n) / N);
-            T term2 = std::cos((4.0 * M_PI * n) / N);
+            T term1 = FastMath<T>::cos((2.0 * M_PI * n) / N);
+            T term2 = FastMath<T>::cos((4.0 * M_PI * n) / N);
             T val = 0.42 - 0.5 * term1 + 0.08 * term2;
             this->m_factors[i] = static_cast<T>(val);
         }
     }
 
+    /**
+     * \brief Configures a Slepian (DPSS) window.
+     *
+     * Uses a discrete prolate spheroidal sequence, which puts the largest
+     * possible fraction of its energy into the main lobe |f| < NW / Size.
+     * The sequence comes from the shared Dpss cache, so configuring many
+     * windows of one design computes it only once. Coefficients are scaled
+     * to a peak of 1 like the other windows.
+     *
+     * \param bandwidth Time-bandwidth product NW (0 < NW < Size/2), typically 2 to 4.
+     * \param order Taper order k (0 for the usual window, higher orders are less concentrated).
+     *
+     * \throws std::invalid_argument if bandwidth or order is out of range.
+     */
+    void setupSlepian(T bandwidth, size_t order = 0) {
+        std::shared_ptr<const Dpss<T>> tapers = Dpss<T>::get(Size, bandwidth, order + 1);
+        const T* taper = tapers->taper(order);
+        T peak = static_cast<T>(0.0);
+        for (size_t i = 0; i < Size; i++) {
+            peak = std::max(peak, std::abs(taper[i]));
+        }
+        for (size_t i = 0; i < Size; i++) {
+            this->m_factors[i] = taper[i] / peak;
+        }
+    }
+
     /**
      * \brief Creates a new Window with rectangular coefficients.
      *
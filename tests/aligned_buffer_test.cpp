@@ -0,0 +1,63 @@
+#include <iostream>
+#include <vector>
+
+#include "AlignedBuffer.hpp"
+#include "DynamicFirFilter.hpp"
+
+namespace {
+/// @brief Checks that a buffer holds the expected elements
+bool holds(const char* name, const md::AlignedBuffer<double>& buffer, const std::vector<double>& expected) {
+    if (buffer.size() != expected.size() || buffer.capacity() < md::paddedLength<double>(expected.size())) {
+        std::cerr << name << ": size is " << buffer.size() << ", expected " << expected.size() << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (buffer[i] != expected[i]) {
+            std::cerr << name << ": element " << i << " is " << buffer[i] << ", expected " << expected[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+int main() {
+    bool passed = true;
+
+    // A shrunk buffer keeps its large capacity, a copy only gets room for its size
+    md::AlignedBuffer<double> shrunk(1000);
+    shrunk.resize(3);
+    shrunk[0] = 1.0;
+    shrunk[1] = 2.0;
+    shrunk[2] = 3.0;
+    md::AlignedBuffer<double> copied(shrunk);
+    passed &= holds("copy of shrunk buffer", copied, {1.0, 2.0, 3.0});
+
+    md::AlignedBuffer<double> assigned;
+    assigned = shrunk;
+    passed &= holds("assignment of shrunk buffer", assigned, {1.0, 2.0, 3.0});
+
+    // Copy assignment takes over the policy, like the copy constructor
+    md::MemoryPolicy policy;
+    policy.prefault = true;
+    md::AlignedBuffer<double> source(4, policy);
+    md::AlignedBuffer<double> target(64);
+    target = source;
+    if (target.policy() != policy) {
+        std::cerr << "assignment: policy not copied" << std::endl;
+        passed = false;
+    }
+
+    // Filters are copied through the same path
+    md::DynamicFirFilter<double> filter(1000);
+    filter.setFactors({1.0, 2.0, 3.0});
+    md::DynamicFirFilter<double> copy(filter);
+    std::vector<double> signal = {1.0, 0.0, 0.0, 0.0};
+    copy.process(signal.data(), signal.size());
+    if (signal != std::vector<double>{1.0, 2.0, 3.0, 0.0}) {
+        std::cerr << "filter copy: wrong impulse response" << std::endl;
+        passed = false;
+    }
+
+    return passed ? 0 : 1;
+}
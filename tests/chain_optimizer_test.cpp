@@ -0,0 +1,126 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ChainOptimizer.hpp"
+
+namespace {
+/// @brief Runs an impulse through a chain
+std::vector<double> impulseResponse(md::FilterChain<double>& chain, size_t length) {
+    std::vector<double> signal(length, 0.0);
+    signal[0] = 1.0;
+    chain.reset();
+    chain.process(signal.data(), signal.size());
+    return signal;
+}
+
+/// @brief Checks that optimize() keeps the output of a chain and does not make it more expensive
+bool keepsOutput(const char* name, md::FilterChain<double> chain) {
+    std::vector<double> expected = impulseResponse(chain, 64);
+    md::ChainReport report = md::ChainOptimizer<double>().optimize(chain);
+    if (report.costAfter > report.costBefore) {
+        std::cerr << name << ": cost grew from " << report.costBefore << " to " << report.costAfter << std::endl;
+        return false;
+    }
+    std::vector<double> actual = impulseResponse(chain, 64);
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (!(std::abs(actual[i] - expected[i]) <= 1e-12 * (1 + std::abs(expected[i])))) {
+            std::cerr << name << ": sample " << i << " is " << actual[i] << ", expected " << expected[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Builds a chain of random linear stages with stable poles
+md::FilterChain<double> randomChain(std::mt19937& generator) {
+    std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+    std::uniform_real_distribution<double> radius(0.1, 0.9);
+    std::uniform_int_distribution<int> kind(0, 5);
+    std::uniform_int_distribution<int> count(1, 4);
+    auto section = [&]() {
+        double r = radius(generator);
+        double angle = 3.0 * coefficient(generator);
+        return md::Biquad<double>{1.0 + coefficient(generator) / 2, coefficient(generator), coefficient(generator),
+                                  -2 * r * std::cos(angle), r * r};
+    };
+    md::FilterChain<double> chain;
+    for (int stage = count(generator) + 1; stage > 0; stage--) {
+        switch (kind(generator)) {
+            case 0:
+                chain.add(md::DynamicGain<double>(2 * coefficient(generator)));
+                break;
+            case 1: {
+                std::vector<double> taps(count(generator) * 3);
+                for (double& tap : taps) {
+                    tap = coefficient(generator);
+                }
+                chain.add(md::DynamicFirFilter<double>(taps));
+                break;
+            }
+            case 2: {
+                std::vector<double> b(count(generator));
+                for (double& tap : b) {
+                    tap = coefficient(generator);
+                }
+                chain.add(md::DynamicIirFilter<double>(b, {}));
+                break;
+            }
+            case 3:
+                chain.add(md::DynamicIirFilter<double>({1.0, coefficient(generator)}, {-radius(generator)}));
+                break;
+            case 4: {
+                md::Biquad<double> q = section();
+                chain.add(md::DynamicIirFilter<double>({q.b0, q.b1, q.b2}, {q.a1, q.a2}));
+                break;
+            }
+            default: {
+                std::vector<md::Biquad<double>> sections;
+                for (int i = count(generator); i > 0; i--) {
+                    sections.push_back(section());
+                }
+                chain.add(md::DynamicSosFilter<double>(sections));
+                break;
+            }
+        }
+    }
+    return chain;
+}
+}  // namespace
+
+int main() {
+    bool passed = true;
+
+    // Section with a leading delay (b0 = 0) cannot be normalized by b0
+    md::FilterChain<double> delayed;
+    delayed.add(md::DynamicGain<double>(2.0));
+    delayed.add(md::DynamicSosFilter<double>({{0.0, 1.0, 0.0, -0.5, 0.0}, {1.0, 0.2, 0.0, 0.3, 0.0}}));
+    passed &= keepsOutput("delayed sections", delayed);
+
+    // Regular sections are still fused
+    md::FilterChain<double> sections;
+    sections.add(md::DynamicGain<double>(0.5));
+    sections.add(md::DynamicSosFilter<double>({{1.0, 0.5, 0.25, -0.5, 0.1}}));
+    sections.add(md::DynamicSosFilter<double>({{2.0, -0.4, 0.0, 0.2, 0.0}}));
+    passed &= keepsOutput("regular sections", sections);
+
+    // Pole-free IIR stage is cheaper than a padded FIR kernel
+    md::FilterChain<double> feedforward;
+    feedforward.add(md::DynamicIirFilter<double>({0.5, 0.2}, {}));
+    passed &= keepsOutput("pole-free IIR", feedforward);
+
+    // Merging a first-order stage and a biquad into two sections costs more than the stages
+    md::FilterChain<double> mixed;
+    mixed.add(md::DynamicGain<double>(3.0));
+    mixed.add(md::DynamicIirFilter<double>({1.0, 0.5}, {-0.3}));
+    mixed.add(md::DynamicIirFilter<double>({1.0, 0.2, 0.1}, {-0.5, 0.25}));
+    passed &= keepsOutput("first-order and biquad", mixed);
+
+    std::mt19937 generator(7);
+    for (int i = 0; i < 2000 && passed; i++) {
+        passed &= keepsOutput("random chain", randomChain(generator));
+    }
+
+    return passed ? 0 : 1;
+}
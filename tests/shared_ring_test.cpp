@@ -0,0 +1,199 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "SharedRing.hpp"
+
+namespace {
+/**
+ * \brief Stand-in acquisition process for SharedRing tests.
+ *
+ * Publishes a signal in fixed-size blocks from a background thread, as an
+ * acquisition process would, and closes the ring when done. The ring may be
+ * attached by consumers in the same or in forked processes.
+ *
+ * \tparam T Sample type.
+ */
+template <typename T>
+class RingTestProducer {
+   private:
+    /// \brief Producing thread
+    std::thread m_thread;
+
+   public:
+    /**
+     * \brief Starts publishing.
+     *
+     * \param ring Ring to publish into (must outlive the producer).
+     * \param signal Samples to publish.
+     * \param blockLength Samples per block (<= ring.slotCapacity()).
+     * \param repeats Number of times the signal is published.
+     *
+     * \throws std::invalid_argument if blockLength is 0 or exceeds the slot capacity.
+     */
+    RingTestProducer(md::SharedRing<T>& ring, std::vector<T> signal, size_t blockLength, size_t repeats = 1) {
+        if (blockLength == 0 || blockLength > ring.slotCapacity()) {
+            throw std::invalid_argument("Block length must be in range (0, slotCapacity]!");
+        }
+        m_thread = std::thread([&ring, signal = std::move(signal), blockLength, repeats] {
+            for (size_t r = 0; r < repeats; r++) {
+                for (size_t pos = 0; pos < signal.size(); pos += blockLength) {
+                    size_t count = std::min(blockLength, signal.size() - pos);
+                    T* slot = ring.acquire();
+                    std::copy(signal.begin() + pos, signal.begin() + pos + count, slot);
+                    ring.publish(count);
+                }
+            }
+            ring.close();
+        });
+    }
+
+    RingTestProducer(const RingTestProducer&) = delete;
+    RingTestProducer& operator=(const RingTestProducer&) = delete;
+
+    /// @brief Waits until all blocks are published
+    void join() {
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    /// @brief Waits until all blocks are published
+    ~RingTestProducer() { join(); }
+};
+
+/// @brief Processor that records the blocks it is given
+struct BlockRecorder {
+    std::mutex mutex;
+    std::vector<std::vector<double>> blocks;
+
+    void process(double* data, size_t length) {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocks.emplace_back(data, data + length);
+    }
+};
+
+/// @brief Checks that blocks hold a signal published repeats times in blocks of blockLength
+bool holdsSignal(const char* name, const std::vector<std::vector<double>>& blocks, const std::vector<double>& signal,
+                 size_t blockLength, size_t repeats) {
+    size_t perSignal = (signal.size() + blockLength - 1) / blockLength;
+    if (blocks.size() != perSignal * repeats) {
+        std::cerr << name << ": got " << blocks.size() << " blocks, expected " << perSignal * repeats << std::endl;
+        return false;
+    }
+    for (size_t b = 0; b < blocks.size(); b++) {
+        size_t pos = (b % perSignal) * blockLength;
+        std::vector<double> expected(signal.begin() + pos,
+                                     signal.begin() + std::min(pos + blockLength, signal.size()));
+        if (blocks[b] != expected) {
+            std::cerr << name << ": block " << b << " differs" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+int main() {
+    bool passed = true;
+    std::vector<double> signal(1000);
+    for (size_t i = 0; i < signal.size(); i++) {
+        signal[i] = static_cast<double>(i);
+    }
+
+    // A single consumer sees every block in order, across many laps of a small ring
+    {
+        md::SharedRing<double> ring = md::SharedRing<double>::create(4, 8);
+        RingTestProducer<double> producer(ring, signal, 7, 3);
+        std::vector<std::vector<double>> blocks;
+        uint64_t sequence = 0;
+        while (md::RingBlock<double> block = ring.claim()) {
+            if (block.sequence != sequence++) {
+                std::cerr << "single consumer: block " << block.sequence << " out of order" << std::endl;
+                passed = false;
+            }
+            blocks.emplace_back(block.data, block.data + block.length);
+            ring.release(block);
+        }
+        producer.join();
+        passed &= holdsSignal("single consumer", blocks, signal, 7, 3);
+    }
+
+    // Several consumers share the blocks, each block is processed exactly once
+    {
+        md::SharedRing<double> ring = md::SharedRing<double>::create(4, 16);
+        RingTestProducer<double> producer(ring, signal, 16, 5);
+        BlockRecorder recorder;
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < 3; c++) {
+            consumers.emplace_back([&ring, &recorder] { ring.consume(recorder); });
+        }
+        for (std::thread& consumer : consumers) {
+            consumer.join();
+        }
+        producer.join();
+        // Consumers finish blocks in any order, so the sorted blocks are compared
+        std::vector<std::vector<double>> expected;
+        for (size_t r = 0; r < 5; r++) {
+            for (size_t pos = 0; pos < signal.size(); pos += 16) {
+                expected.emplace_back(signal.begin() + pos, signal.begin() + std::min(pos + 16, signal.size()));
+            }
+        }
+        std::sort(recorder.blocks.begin(), recorder.blocks.end());
+        std::sort(expected.begin(), expected.end());
+        if (recorder.blocks != expected) {
+            std::cerr << "shared consumers: got " << recorder.blocks.size() << " blocks, expected "
+                      << expected.size() << std::endl;
+            passed = false;
+        }
+    }
+
+    // A consumer in another process attaches through the descriptor
+    {
+        md::SharedRing<double> ring = md::SharedRing<double>::create(8, 32);
+        pid_t child = ::fork();
+        if (child == 0) {
+            bool ok = false;
+            try {
+                md::SharedRing<double> attached = md::SharedRing<double>::fromFd(ring.fd());
+                BlockRecorder recorder;
+                attached.consume(recorder);
+                ok = holdsSignal("forked consumer", recorder.blocks, signal, 32, 2);
+            } catch (const std::exception& e) {
+                std::cerr << "forked consumer: " << e.what() << std::endl;
+            }
+            ::_exit(ok ? 0 : 1);
+        }
+        if (child < 0) {
+            std::cerr << "forked consumer: fork failed" << std::endl;
+            passed = false;
+        } else {
+            RingTestProducer<double> producer(ring, signal, 32, 2);
+            producer.join();
+            int status = 0;
+            if (::waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cerr << "forked consumer: failed" << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    // Blocks larger than a slot are rejected before the producer starts
+    {
+        md::SharedRing<double> ring = md::SharedRing<double>::create(2, 4);
+        try {
+            RingTestProducer<double> producer(ring, signal, 5);
+            std::cerr << "oversized blocks: accepted" << std::endl;
+            passed = false;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+
+    return passed ? 0 : 1;
+}
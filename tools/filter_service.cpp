@@ -0,0 +1,187 @@
+// Filter service tool - keeps designed filter chains loaded and filters raw f64 files on request
+//
+// Usage:
+//   DSP_FilterService serve <socket> <threads> <name>=<stage>[;<stage>...] ...
+//   DSP_FilterService process <socket> <chain> <input.f64> <output.f64>
+//   DSP_FilterService stats <socket>
+//
+// Stages:
+//   lowpass:<taps>:<freq>   highpass:<taps>:<freq>   bandpass:<taps>:<low>:<high>
+//   iir:<b0,b1,...>:<a1,a2,...>   gain:<factor>
+//
+// Chains are simplified with ChainOptimizer before they are loaded.
+
+#include <csignal>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ChainOptimizer.hpp"
+#include "DynamicFirFilter.hpp"
+#include "DynamicGain.hpp"
+#include "DynamicIirFilter.hpp"
+#include "FilterChain.hpp"
+#include "FilterService.hpp"
+
+namespace {
+/// @brief Splits a string at a separator
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+/// @brief Parses a comma-separated coefficient list
+std::vector<double> parseList(const std::string& text) {
+    std::vector<double> values;
+    for (const std::string& value : split(text, ',')) {
+        values.push_back(std::stod(value));
+    }
+    return values;
+}
+
+/// @brief Builds a chain from ';'-separated stage descriptions
+md::FilterChain<double> parseChain(const std::string& spec) {
+    md::FilterChain<double> chain;
+    for (const std::string& stage : split(spec, ';')) {
+        std::vector<std::string> fields = split(stage, ':');
+        if (fields.size() == 3 && fields[0] == "lowpass") {
+            chain.emplace<md::DynamicFirFilter<double>>(std::stoul(fields[1])).setupLowPass(std::stod(fields[2]));
+        } else if (fields.size() == 3 && fields[0] == "highpass") {
+            chain.emplace<md::DynamicFirFilter<double>>(std::stoul(fields[1])).setupHighPass(std::stod(fields[2]));
+        } else if (fields.size() == 4 && fields[0] == "bandpass") {
+            chain.emplace<md::DynamicFirFilter<double>>(std::stoul(fields[1]))
+                .setupBandPass(std::stod(fields[2]), std::stod(fields[3]));
+        } else if (fields.size() == 2 && fields[0] == "gain") {
+            chain.emplace<md::DynamicGain<double>>(std::stod(fields[1]));
+        } else if (fields.size() == 3 && fields[0] == "iir") {
+            chain.emplace<md::DynamicIirFilter<double>>(parseList(fields[1]), parseList(fields[2]));
+        } else {
+            throw std::invalid_argument("Unknown stage: " + stage);
+        }
+    }
+    return chain;
+}
+
+/// @brief Reads a raw f64 file into a prefaulted, huge-page backed shared buffer
+std::unique_ptr<md::SharedBuffer<double>> readRaw(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::invalid_argument("File can not be open!");
+    }
+    std::fseek(file, 0, SEEK_END);
+    long bytes = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    size_t count = bytes > 0 ? static_cast<size_t>(bytes) / sizeof(double) : 0;
+    if (count == 0) {
+        std::fclose(file);
+        throw std::invalid_argument("Bad array!");
+    }
+    md::MemoryPolicy policy;
+    policy.pages = md::PageMode::Transparent;
+    policy.prefault = true;
+    auto buffer = std::make_unique<md::SharedBuffer<double>>(count, policy);
+    bool read = std::fread(buffer->data(), sizeof(double), count, file) == count;
+    std::fclose(file);
+    if (!read) {
+        throw std::runtime_error("Failed to read data");
+    }
+    return buffer;
+}
+
+/// @brief Writes a raw f64 file
+void writeRaw(const std::string& path, const double* samples, size_t count) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::invalid_argument("File can not be open!");
+    }
+    bool written = std::fwrite(samples, sizeof(double), count, file) == count;
+    std::fclose(file);
+    if (!written) {
+        throw std::runtime_error("Failed to write data");
+    }
+}
+
+/// @brief Prints service counters
+void printStats(const md::ServiceStats& stats) {
+    std::cout << "requests " << stats.requests << std::endl
+              << "batches " << stats.batches << std::endl
+              << "samples " << stats.samples << std::endl
+              << "errors " << stats.errors << std::endl
+              << "mean queue latency " << stats.meanQueueLatency * 1e6 << " us" << std::endl
+              << "max queue latency " << stats.maxQueueLatency * 1e6 << " us" << std::endl
+              << "throughput " << stats.throughput << " samples/s" << std::endl
+              << "uptime " << stats.uptime << " s" << std::endl;
+}
+
+int usage() {
+    std::cerr << "Usage:" << std::endl
+              << "  DSP_FilterService serve <socket> <threads> <name>=<stage>[;<stage>...] ..." << std::endl
+              << "  DSP_FilterService process <socket> <chain> <input.f64> <output.f64>" << std::endl
+              << "  DSP_FilterService stats <socket>" << std::endl
+              << "Stages: lowpass:<taps>:<freq> highpass:<taps>:<freq> bandpass:<taps>:<low>:<high>" << std::endl
+              << "        iir:<b0,b1,...>:<a1,a2,...> gain:<factor>" << std::endl;
+    return 1;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        return usage();
+    }
+    std::string command = argv[1];
+    try {
+        if (command == "serve" && argc >= 5) {
+            md::FilterService<double> service(argv[2], std::stoul(argv[3]));
+            for (int i = 4; i < argc; i++) {
+                std::string definition = argv[i];
+                size_t separator = definition.find('=');
+                if (separator == std::string::npos) {
+                    return usage();
+                }
+                md::FilterChain<double> chain = parseChain(definition.substr(separator + 1));
+                md::ChainReport report = md::ChainOptimizer<double>().optimize(chain);
+                std::cout << definition.substr(0, separator) << ": " << report.stagesBefore << " stages ("
+                          << report.costBefore << " MAC/sample) -> " << report.stagesAfter << " stages ("
+                          << report.costAfter << " MAC/sample)" << std::endl;
+                service.addChain(definition.substr(0, separator), chain);
+            }
+
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGINT);
+            sigaddset(&signals, SIGTERM);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+            service.start();
+            std::cout << "Serving " << (argc - 4) << " chains on " << argv[2] << std::endl;
+            int received = 0;
+            sigwait(&signals, &received);
+            service.stop();
+            printStats(service.stats());
+        } else if (command == "process" && argc == 6) {
+            std::unique_ptr<md::SharedBuffer<double>> buffer = readRaw(argv[4]);
+            md::FilterClient<double> client(argv[2]);
+            double latency = client.process(argv[3], *buffer, buffer->capacity());
+            writeRaw(argv[5], buffer->data(), buffer->capacity());
+            std::cout << "Filtered " << buffer->capacity() << " samples (queued " << latency * 1e6 << " us)"
+                      << std::endl;
+        } else if (command == "stats") {
+            md::FilterClient<double> client(argv[2]);
+            printStats(client.stats());
+        } else {
+            return usage();
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Summary pyramid tool - builds and queries min/max/RMS sidecar files of long recordings
+//
+// Usage:
+//   DSP_Pyramid build <input> <sidecar> [f32|f64|txt] [blockSize]
+//   DSP_Pyramid query <sidecar> <begin> <end>
+//   DSP_Pyramid active <sidecar> <threshold>
+//   DSP_Pyramid envelope <sidecar> <begin> <end> <points>
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SummaryPyramid.hpp"
+
+namespace {
+/// @brief Number of samples read per streaming step
+constexpr size_t kChunk = 1 << 16;
+
+/// @brief Streams a raw binary file of Sample values into the pyramid
+template <typename Sample>
+void appendRaw(const std::string& path, md::SummaryPyramid<double>& pyramid) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::invalid_argument("File can not be open!");
+    }
+    std::vector<Sample> raw(kChunk);
+    std::vector<double> samples(kChunk);
+    size_t count = 0;
+    while ((count = std::fread(raw.data(), sizeof(Sample), kChunk, file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            samples[i] = static_cast<double>(raw[i]);
+        }
+        pyramid.append(samples.data(), count);
+    }
+    std::fclose(file);
+}
+
+/// @brief Streams a whitespace-separated text file (test_data format) into the pyramid
+void appendText(const std::string& path, md::SummaryPyramid<double>& pyramid) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("File can not be open!");
+    }
+    std::vector<double> samples;
+    samples.reserve(kChunk);
+    double value = 0.0;
+    while (file >> value) {
+        samples.push_back(value);
+        if (samples.size() == kChunk) {
+            pyramid.append(samples.data(), samples.size());
+            samples.clear();
+        }
+    }
+    pyramid.append(samples.data(), samples.size());
+}
+
+/// @brief Prints one summary line
+void print(size_t begin, size_t end, const md::BlockSummary<double>& summary) {
+    std::cout << begin << " " << end << " min " << summary.min << " max " << summary.max << " rms " << summary.rms()
+              << std::endl;
+}
+
+int usage() {
+    std::cerr << "Usage:" << std::endl
+              << "  DSP_Pyramid build <input> <sidecar> [f32|f64|txt] [blockSize]" << std::endl
+              << "  DSP_Pyramid query <sidecar> <begin> <end>" << std::endl
+              << "  DSP_Pyramid active <sidecar> <threshold>" << std::endl
+              << "  DSP_Pyramid envelope <sidecar> <begin> <end> <points>" << std::endl;
+    return 1;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        return usage();
+    }
+    std::string command = argv[1];
+    try {
+        if (command == "build") {
+            std::string format = argc > 4 ? argv[4] : "f32";
+            md::SummaryPyramid<double> pyramid(argc > 5 ? std::stoul(argv[5]) : 256);
+            if (format == "f32") {
+                appendRaw<float>(argv[2], pyramid);
+            } else if (format == "f64") {
+                appendRaw<double>(argv[2], pyramid);
+            } else if (format == "txt") {
+                appendText(argv[2], pyramid);
+            } else {
+                return usage();
+            }
+            pyramid.finish();
+            pyramid.save(argv[3]);
+            std::cout << "Indexed " << pyramid.length() << " samples in " << pyramid.levels() << " levels"
+                      << std::endl;
+        } else if (command == "query" && argc == 5) {
+            auto pyramid = md::SummaryPyramid<double>::load(argv[2]);
+            size_t begin = std::stoul(argv[3]);
+            size_t end = std::stoul(argv[4]);
+            print(begin, end, pyramid.query(begin, end));
+        } else if (command == "active") {
+            auto pyramid = md::SummaryPyramid<double>::load(argv[2]);
+            for (const auto& range : pyramid.findActive(std::stod(argv[3]))) {
+                print(range.first, range.second, pyramid.query(range.first, range.second));
+            }
+        } else if (command == "envelope" && argc == 6) {
+            auto pyramid = md::SummaryPyramid<double>::load(argv[2]);
+            size_t begin = std::stoul(argv[3]);
+            size_t end = std::stoul(argv[4]);
+            size_t points = std::stoul(argv[5]);
+            std::vector<md::BlockSummary<double>> envelope = pyramid.envelope(begin, end, points);
+            for (size_t p = 0; p < points; p++) {
+                print(begin + (end - begin) * p / points, begin + (end - begin) * (p + 1) / points, envelope[p]);
+            }
+        } else {
+            return usage();
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}